@@ -0,0 +1,649 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "CustomString/CustomString.h"
+#include "CustomString/StringArena.h"
+#include "CustomString/BufferPool.h"
+#include "CustomString/StringInterner.h"
+#include "CustomString/PatternMatcher.h"
+#include "CustomString/Searcher.h"
+#include "CustomString/ApproxSearcher.h"
+#include "CustomString/CharSet.h"
+#include "CustomString/StringLookup.h"
+
+#include <cstdio> /* std::printf() */
+#include <vector> /* std::vector */
+#include <string> /* std::to_string() */
+#include <algorithm> /* std::sort() */
+#include <string_view> /* std::string_view */
+#include <unordered_map> /* std::unordered_map */
+
+/* Benchmarks are hidden from the default test run, run them with the [benchmark] tag */
+
+TEST_CASE("Benchmark String Arena", "[.][benchmark]")
+{
+	constexpr size_t NrOfStrings{ 1000 };
+	constexpr const char* pKey{ "request/handler/some-parameter-name" };
+
+	BENCHMARK("Heap strings")
+	{
+		size_t totalSize{};
+
+		for (size_t i{}; i < NrOfStrings; ++i)
+		{
+			CustomString<char> string{ pKey };
+			string += "=value";
+			totalSize += string.Size();
+		}
+
+		return totalSize;
+	};
+
+	StringArena arena{};
+
+	BENCHMARK("Arena strings")
+	{
+		size_t totalSize{};
+
+		for (size_t i{}; i < NrOfStrings; ++i)
+		{
+			ArenaString<char> string{ pKey, arena };
+			string += "=value";
+			totalSize += string.Size();
+		}
+
+		arena.Reset();
+
+		return totalSize;
+	};
+}
+
+namespace
+{
+	struct TrackingStats final
+	{
+		size_t NrOfAllocations{};
+		size_t BytesInUse{};
+		size_t PeakBytesInUse{};
+	};
+
+	template<typename T>
+	struct TrackingAllocator final
+	{
+		using value_type = T;
+
+		explicit TrackingAllocator(TrackingStats* pStats)
+			: pStats{ pStats }
+		{}
+
+		T* allocate(const size_t n)
+		{
+			++pStats->NrOfAllocations;
+			pStats->BytesInUse += n * sizeof(T);
+			pStats->PeakBytesInUse = std::max(pStats->PeakBytesInUse, pStats->BytesInUse);
+
+			return std::allocator<T>{}.allocate(n);
+		}
+
+		void deallocate(T* p, const size_t n)
+		{
+			pStats->BytesInUse -= n * sizeof(T);
+			std::allocator<T>{}.deallocate(p, n);
+		}
+
+		bool operator==(const TrackingAllocator& other) const { return pStats == other.pStats; }
+
+		TrackingStats* pStats;
+	};
+
+	/* Builds a log line out of many small appends, the way our log builders do */
+	template<typename GrowthPolicy>
+	void MeasureGrowth(const char* pName, const size_t nrOfAppends)
+	{
+		TrackingStats stats{};
+
+		{
+			CustomString<char, TrackingAllocator<char>, GrowthPolicy> string{ TrackingAllocator<char>{ &stats } };
+
+			for (size_t i{}; i < nrOfAppends; ++i)
+				string += "key=value ";
+		}
+
+		std::printf("%-20s %10zu appends %10zu reallocations %12zu peak bytes\n", pName, nrOfAppends, stats.NrOfAllocations, stats.PeakBytesInUse);
+	}
+
+	template<typename GrowthPolicy>
+	size_t AppendMany(const size_t nrOfAppends)
+	{
+		CustomString<char, std::allocator<char>, GrowthPolicy> string{};
+
+		for (size_t i{}; i < nrOfAppends; ++i)
+			string += "key=value ";
+
+		return string.Size();
+	}
+}
+
+TEST_CASE("Benchmark Growth Policies", "[.][benchmark]")
+{
+	for (const size_t nrOfAppends : { 100u, 1'000u, 10'000u })
+	{
+		MeasureGrowth<GrowOnePointFive>("GrowOnePointFive", nrOfAppends);
+		MeasureGrowth<GrowDouble>("GrowDouble", nrOfAppends);
+		MeasureGrowth<GrowExact>("GrowExact", nrOfAppends);
+		MeasureGrowth<GrowPowerOfTwo>("GrowPowerOfTwo", nrOfAppends);
+		MeasureGrowth<GrowToSizeClass<>>("GrowToSizeClass", nrOfAppends);
+	}
+
+	constexpr size_t NrOfAppends{ 10'000 };
+
+	BENCHMARK("GrowOnePointFive") { return AppendMany<GrowOnePointFive>(NrOfAppends); };
+	BENCHMARK("GrowDouble") { return AppendMany<GrowDouble>(NrOfAppends); };
+	BENCHMARK("GrowExact") { return AppendMany<GrowExact>(NrOfAppends); };
+	BENCHMARK("GrowPowerOfTwo") { return AppendMany<GrowPowerOfTwo>(NrOfAppends); };
+	BENCHMARK("GrowToSizeClass") { return AppendMany<GrowToSizeClass<>>(NrOfAppends); };
+}
+
+TEST_CASE("Benchmark String Interner", "[.][benchmark]")
+{
+	constexpr size_t NrOfNames{ 1000 };
+
+	/* Metric names share long prefixes, which is the worst case for a character-by-character compare */
+	std::vector<CustomString<char>> names{};
+	for (size_t i{}; i < NrOfNames; ++i)
+	{
+		CustomString<char> name{ "service.requests.latency.p99." };
+		name += CustomString<char>{ static_cast<char>('a' + i % 26), i / 26 + 1 };
+		names.push_back(name);
+	}
+
+	StringInterner<char> interner{};
+	std::vector<InternedString<char>> handles(NrOfNames);
+	interner.InternAll(names.begin(), names.end(), handles.begin());
+
+	BENCHMARK("CustomString equality")
+	{
+		size_t nrOfMatches{};
+
+		for (size_t i{}; i < NrOfNames; ++i)
+			nrOfMatches += names[i] == names[NrOfNames - 1 - i];
+
+		return nrOfMatches;
+	};
+
+	BENCHMARK("Handle equality")
+	{
+		size_t nrOfMatches{};
+
+		for (size_t i{}; i < NrOfNames; ++i)
+			nrOfMatches += handles[i] == handles[NrOfNames - 1 - i];
+
+		return nrOfMatches;
+	};
+
+	BENCHMARK("Interning existing names")
+	{
+		size_t totalId{};
+
+		for (const CustomString<char>& name : names)
+			totalId += interner.Intern(name).GetId();
+
+		return totalId;
+	};
+}
+
+TEST_CASE("Benchmark IndexOf Character", "[.][benchmark]")
+{
+	std::printf("Dispatching to instruction set %d (0 = scalar, 1 = SSE2, 2 = SSSE3, 3 = AVX2)\n", static_cast<int>(StringSearch::GetInstructionSet()));
+
+	for (const size_t size : { 8u, 64u, 512u, 4u * 1024u, 32u * 1024u, 256u * 1024u, 1024u * 1024u })
+	{
+		CustomString<char> atStart{ 'a', size };
+		atStart[0] = 'x';
+
+		CustomString<char> inMiddle{ 'a', size };
+		inMiddle[size / 2] = 'x';
+
+		const CustomString<char> missing{ 'a', size };
+
+		const std::string suffix{ " " + std::to_string(size) + " bytes" };
+
+		BENCHMARK("Scalar, hit at start" + suffix) { return StringSearch::FindByte(atStart.Data(), size, 'x', StringSearch::InstructionSet::Scalar); };
+		BENCHMARK("IndexOf, hit at start" + suffix) { return atStart.IndexOf('x'); };
+		BENCHMARK("Scalar, hit in middle" + suffix) { return StringSearch::FindByte(inMiddle.Data(), size, 'x', StringSearch::InstructionSet::Scalar); };
+		BENCHMARK("IndexOf, hit in middle" + suffix) { return inMiddle.IndexOf('x'); };
+		BENCHMARK("Scalar, missing" + suffix) { return StringSearch::FindByte(missing.Data(), size, 'x', StringSearch::InstructionSet::Scalar); };
+		BENCHMARK("IndexOf, missing" + suffix) { return missing.IndexOf('x'); };
+	}
+}
+
+TEST_CASE("Benchmark IndexOf Substring", "[.][benchmark]")
+{
+	/* The previous double loop, kept around as the baseline */
+	const auto naiveIndexOf = [](const CustomString<char>& haystack, const CustomString<char>& needle)
+	{
+		for (size_t i{}; i + needle.Size() <= haystack.Size(); ++i)
+		{
+			size_t j{};
+			while (j < needle.Size() && haystack[i + j] == needle[j])
+				++j;
+
+			if (j == needle.Size())
+				return i;
+		}
+
+		return CustomString<char>::NoPos;
+	};
+
+	for (const size_t needleSize : { 16u, 256u, 1024u })
+	{
+		/* "aaa...a" searched for "aaa...b": every position matches all but the last character */
+		const CustomString<char> haystack{ 'a', 64u * 1024u };
+
+		CustomString<char> needle{ 'a', needleSize - 1 };
+		needle += "b";
+
+		const std::string suffix{ ", adversarial, needle of " + std::to_string(needleSize) + " bytes" };
+
+		BENCHMARK("Naive" + suffix) { return naiveIndexOf(haystack, needle); };
+		BENCHMARK("IndexOf" + suffix) { return haystack.IndexOf(needle); };
+	}
+
+	CustomString<char> text{};
+	while (text.Size() < 64u * 1024u)
+		text += "GET /api/v1/users/12345/profile?fields=name,email HTTP/1.1\r\n";
+	text += "X-Request-Id: 0123456789abcdef\r\n";
+
+	const CustomString<char> needle{ "X-Request-Id" };
+
+	BENCHMARK("Naive, request log") { return naiveIndexOf(text, needle); };
+	BENCHMARK("IndexOf, request log") { return text.IndexOf(needle); };
+}
+
+TEST_CASE("Benchmark Vectorized Substring Search", "[.][benchmark]")
+{
+	using StringSearch::InstructionSet;
+
+	for (const size_t size : { 64u, 1024u, 16u * 1024u, 256u * 1024u })
+	{
+		CustomString<char> text{};
+		while (text.Size() < size)
+			text += "GET /api/v1/users/12345/profile?fields=name,email HTTP/1.1\r\n";
+		text += "X-Request-Id: 0123456789abcdef\r\n";
+
+		const CustomString<char> needle{ "X-Request-Id" };
+		const std::string suffix{ ", " + std::to_string(text.Size()) + " bytes" };
+
+		BENCHMARK("Two-Way" + suffix) { return StringSearch::FindSubstring(text.Data(), text.Size(), needle.Data(), needle.Size()); };
+		BENCHMARK("SSE2 filter" + suffix) { return StringSearch::FindBytes(text.Data(), text.Size(), needle.Data(), needle.Size(), InstructionSet::SSE2); };
+		if (StringSearch::GetInstructionSet() == InstructionSet::AVX2)
+			BENCHMARK("AVX2 filter" + suffix) { return StringSearch::FindBytes(text.Data(), text.Size(), needle.Data(), needle.Size(), InstructionSet::AVX2); };
+	}
+}
+
+TEST_CASE("Benchmark Pattern Matcher", "[.][benchmark]")
+{
+	/* Hundreds of forbidden tokens, none of which occur in the message */
+	std::vector<CustomString<char>> tokens{};
+	for (size_t i{}; i < 300; ++i)
+	{
+		CustomString<char> token{ "forbidden_" };
+		token += CustomString<char>{ static_cast<char>('a' + i % 26), 1 + i / 26 };
+		tokens.push_back(token);
+	}
+
+	CustomString<char> message{};
+	while (message.Size() < 4u * 1024u)
+		message += "user=alice action=login status=ok forwarded_for=10.0.0.1 ";
+
+	const PatternMatcher<char> matcher{ tokens };
+
+	std::printf("%zu patterns, %zu states, %zu character classes, %zu bytes\n",
+		matcher.NrOfPatterns(), matcher.NrOfStates(), matcher.NrOfCharacterClasses(), matcher.MemoryUsage());
+
+	BENCHMARK("Contains per pattern")
+	{
+		for (const CustomString<char>& token : tokens)
+		{
+			if (message.Contains(token))
+				return true;
+		}
+
+		return false;
+	};
+
+	BENCHMARK("ContainsAny") { return matcher.ContainsAny(message); };
+}
+
+TEST_CASE("Benchmark Searcher", "[.][benchmark]")
+{
+	uint32_t seed{ 1 };
+	const auto random = [&seed](const uint32_t max)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 16) % max;
+	};
+
+	for (const uint32_t alphabetSize : { 2u, 4u, 26u, 95u })
+	{
+		/* Random text over the alphabet, the needle is placed at the very end */
+		CustomString<char> haystack{ ' ', 64u * 1024u };
+		for (size_t i{}; i < haystack.Size(); ++i)
+			haystack[i] = static_cast<char>(' ' + random(alphabetSize));
+
+		for (const size_t needleSize : { 4u, 16u, 64u, 256u })
+		{
+			const CustomString<char> needle{ haystack.Substring(haystack.Size() - needleSize, needleSize) };
+			const Searcher<char> searcher{ needle };
+
+			const std::string suffix{ ", alphabet of " + std::to_string(alphabetSize) + ", needle of " + std::to_string(needleSize) };
+
+			BENCHMARK("IndexOf" + suffix) { return haystack.IndexOf(needle); };
+			BENCHMARK("Searcher" + suffix) { return haystack.IndexOf(searcher); };
+		}
+	}
+}
+
+TEST_CASE("Benchmark LastIndexOf", "[.][benchmark]")
+{
+	for (const size_t size : { 64u, 1024u, 16u * 1024u })
+	{
+		/* The separator is near the start, so the whole string has to be scanned backwards */
+		CustomString<char> path{ 'a', size };
+		path[3] = '/';
+
+		const std::string suffix{ ", " + std::to_string(size) + " bytes" };
+
+		BENCHMARK("Reverse loop over operator[]" + suffix)
+		{
+			for (size_t i{ path.Size() }; i > 0; --i)
+			{
+				if (path[i - 1] == '/')
+					return i - 1;
+			}
+
+			return CustomString<char>::NoPos;
+		};
+
+		BENCHMARK("LastIndexOf(T)" + suffix) { return path.LastIndexOf('/'); };
+		BENCHMARK("LastIndexOf(const T*)" + suffix) { return path.LastIndexOf("/a"); };
+	}
+}
+
+TEST_CASE("Benchmark IndexOfAny", "[.][benchmark]")
+{
+	constexpr const char* pDelimiters{ " \t\r\n,;" };
+	const CharSet delimiters{ pDelimiters };
+
+	for (const size_t size : { 16u, 256u, 4u * 1024u, 64u * 1024u })
+	{
+		/* One long token, the delimiter comes at the very end */
+		CustomString<char> token{ 'a', size };
+		token[size - 1] = ';';
+
+		const std::string suffix{ ", " + std::to_string(size) + " bytes" };
+
+		BENCHMARK("IndexOf per delimiter" + suffix)
+		{
+			size_t first{ CustomString<char>::NoPos };
+
+			for (const char* p{ pDelimiters }; *p != '\0'; ++p)
+				first = std::min(first, token.IndexOf(*p));
+
+			return first;
+		};
+
+		BENCHMARK("IndexOfAny" + suffix) { return token.IndexOfAny(delimiters); };
+	}
+}
+
+TEST_CASE("Benchmark FindAll", "[.][benchmark]")
+{
+	for (const size_t size : { 256u, 4u * 1024u, 64u * 1024u })
+	{
+		/* A comma separated line with a field every 16 bytes */
+		CustomString<char> line{ 'a', size };
+		for (size_t i{ 15 }; i < size; i += 16)
+			line[i] = ',';
+
+		const std::string suffix{ ", " + std::to_string(size) + " bytes" };
+
+		BENCHMARK("Substring and IndexOf" + suffix)
+		{
+			size_t count{};
+			size_t offset{};
+			CustomString<char> rest{ line };
+
+			for (size_t index{ rest.IndexOf(",") }; index != CustomString<char>::NoPos; index = rest.IndexOf(","))
+			{
+				++count;
+				offset += index + 1;
+				if (offset == line.Size())
+					break;
+
+				rest = line.Substring(offset);
+			}
+
+			return count;
+		};
+
+		BENCHMARK("Count" + suffix) { return line.Count(","); };
+	}
+}
+
+TEST_CASE("Benchmark IgnoreCase", "[.][benchmark]")
+{
+	for (const size_t size : { 64u, 1024u, 16u * 1024u })
+	{
+		CustomString<char> text{ 'x', size };
+		for (size_t i{}; i < size; i += 3)
+			text[i] = 'X';
+		text[size - 4] = 'E';
+		text[size - 3] = 'n';
+		text[size - 2] = 'D';
+
+		CustomString<char> other{ text };
+		other.ToLower();
+
+		const std::string suffix{ ", " + std::to_string(size) + " bytes" };
+
+		BENCHMARK("ToLower copies and IndexOf" + suffix)
+		{
+			CustomString<char> lowerText{ text };
+			CustomString<char> lowerNeedle{ "end" };
+
+			return lowerText.ToLower().IndexOf(lowerNeedle.ToLower());
+		};
+
+		BENCHMARK("IndexOfIgnoreCase" + suffix) { return text.IndexOfIgnoreCase("end"); };
+
+		BENCHMARK("ToLower copies and operator==" + suffix)
+		{
+			CustomString<char> lowerText{ text };
+			CustomString<char> lowerOther{ other };
+
+			return lowerText.ToLower() == lowerOther.ToLower();
+		};
+
+		BENCHMARK("EqualsIgnoreCase" + suffix) { return text.EqualsIgnoreCase(other); };
+	}
+}
+
+TEST_CASE("Benchmark IndexOfApprox", "[.][benchmark]")
+{
+	for (const size_t size : { 256u, 4u * 1024u, 64u * 1024u })
+	{
+		/* The needle sits at the very end of a log line, with one character missing */
+		CustomString<char> line{ 'x', size };
+		const char* pTypo{ "conection refused" };
+		for (size_t i{}; pTypo[i] != '\0'; ++i)
+			line[size - 17 + i] = pTypo[i];
+
+		const ApproxSearcher<char> searcher{ "connection refused" };
+		const ApproxSearcher<char> longSearcher{ CustomString<char>{ 'y', 100 } };
+
+		const std::string suffix{ ", " + std::to_string(size) + " bytes" };
+
+		BENCHMARK("IndexOf (exact, no match)" + suffix) { return line.IndexOf("connection refused"); };
+		BENCHMARK("IndexOfApprox, k = 1" + suffix) { return line.IndexOfApprox("connection refused", 1).Position; };
+		BENCHMARK("ApproxSearcher, k = 1" + suffix) { return line.IndexOfApprox(searcher, 1).Position; };
+		BENCHMARK("ApproxSearcher, k = 0" + suffix) { return line.IndexOfApprox(searcher, 0).Position; };
+		BENCHMARK("ApproxSearcher, 100 byte needle" + suffix) { return line.IndexOfApprox(longSearcher, 10).Position; };
+	}
+}
+
+TEST_CASE("Benchmark operator==", "[.][benchmark]")
+{
+	for (const size_t size : { 16u, 64u, 256u, 1024u, 4u * 1024u })
+	{
+		/* Equal keys in separate buffers, so every character has to be compared */
+		const CustomString<char> key{ 'k', size };
+		const CustomString<char> sameKey{ key };
+
+		const std::string suffix{ ", " + std::to_string(size) + " bytes" };
+
+		BENCHMARK("Character loop" + suffix)
+		{
+			if (key.Size() != sameKey.Size())
+				return false;
+
+			for (size_t i{}; i < key.Size(); ++i)
+			{
+				if (key[i] != sameKey[i])
+					return false;
+			}
+
+			return true;
+		};
+
+		BENCHMARK("operator==(const CustomString&)" + suffix) { return key == sameKey; };
+		BENCHMARK("operator==(const T*)" + suffix) { return key == sameKey.Data(); };
+	}
+}
+
+TEST_CASE("Benchmark operator<=>", "[.][benchmark]")
+{
+	for (const size_t size : { 16u, 64u, 256u, 1024u, 4u * 1024u })
+	{
+		/* Only the last character differs */
+		const CustomString<char> key{ 'k', size };
+		CustomString<char> greaterKey{ key };
+		greaterKey[size - 1] = 'l';
+
+		const std::string suffix{ ", " + std::to_string(size) + " bytes" };
+
+		BENCHMARK("Character loop" + suffix)
+		{
+			const size_t minSize{ std::min(key.Size(), greaterKey.Size()) };
+
+			for (size_t i{}; i < minSize; ++i)
+			{
+				if (key[i] != greaterKey[i])
+					return static_cast<unsigned char>(key[i]) < static_cast<unsigned char>(greaterKey[i]);
+			}
+
+			return key.Size() < greaterKey.Size();
+		};
+
+		BENCHMARK("operator<" + suffix) { return key < greaterKey; };
+	}
+
+	/* Keys with a long shared prefix, like paths or URLs */
+	std::vector<CustomString<char>> keys{};
+	for (size_t i{}; i < 10'000; ++i)
+	{
+		CustomString<char> key{ "https://example.com/some/long/shared/prefix/" };
+		key += CustomString<char>{ std::to_string((i * 7919) % 10'000).c_str() };
+		keys.push_back(key);
+	}
+
+	BENCHMARK("std::sort 10000 keys")
+	{
+		std::vector<CustomString<char>> sorted{ keys };
+		std::sort(sorted.begin(), sorted.end());
+
+		return sorted.front().Size();
+	};
+}
+
+TEST_CASE("Benchmark Hash", "[.][benchmark]")
+{
+	for (const size_t size : { 4u, 16u, 64u, 256u, 1024u, 16u * 1024u })
+	{
+		const CustomString<char> key{ 'k', size };
+
+		const std::string suffix{ ", " + std::to_string(size) + " bytes" };
+
+		BENCHMARK("FNV-1a" + suffix)
+		{
+			uint64_t hash{ 14695981039346656037ull };
+			for (size_t i{}; i < key.Size(); ++i)
+			{
+				hash ^= static_cast<unsigned char>(key[i]);
+				hash *= 1099511628211ull;
+			}
+
+			return hash;
+		};
+
+		BENCHMARK("std::hash<std::string_view>" + suffix) { return std::hash<std::string_view>{}(std::string_view{ key.Data(), key.Size() }); };
+		BENCHMARK("Hash()" + suffix) { return key.Hash(); };
+	}
+}
+
+TEST_CASE("Benchmark Cached Hash", "[.][benchmark]")
+{
+	/* A key that is hashed over and over, as when the same string is looked up in several maps */
+	for (const size_t size : { 16u, 256u, 16u * 1024u })
+	{
+		const CustomString<char> key{ 'k', size };
+		const CustomString<char, std::allocator<char>, GrowOnePointFive, CachedHash> cachedKey{ key.Data() };
+
+		const std::string suffix{ ", " + std::to_string(size) + " bytes" };
+
+		BENCHMARK("NoHashCache" + suffix) { return key.Hash(); };
+		BENCHMARK("CachedHash" + suffix) { return cachedKey.Hash(); };
+	}
+}
+
+TEST_CASE("Benchmark Transparent Lookup", "[.][benchmark]")
+{
+	/* Keys too long for the inline buffer, so a temporary key costs an allocation */
+	std::vector<std::string> names{};
+	for (size_t i{}; i < 1024; ++i)
+		names.push_back("a fairly long key for lookups, number " + std::to_string(i));
+
+	std::unordered_map<CustomString<char>, size_t> map{};
+	std::unordered_map<CustomString<char>, size_t, CustomStringHash<char>, CustomStringEqual<char>> transparentMap{};
+	for (size_t i{}; i < names.size(); ++i)
+	{
+		map.emplace(CustomString<char>{ names[i].c_str() }, i);
+		transparentMap.emplace(CustomString<char>{ names[i].c_str() }, i);
+	}
+
+	BENCHMARK("find(CustomString{ const char* })")
+	{
+		size_t sum{};
+		for (const std::string& name : names)
+			sum += map.find(CustomString<char>{ name.c_str() })->second;
+
+		return sum;
+	};
+
+	BENCHMARK("Transparent find(const char*)")
+	{
+		size_t sum{};
+		for (const std::string& name : names)
+			sum += transparentMap.find(name.c_str())->second;
+
+		return sum;
+	};
+
+	BENCHMARK("Transparent find(std::string_view)")
+	{
+		size_t sum{};
+		for (const std::string& name : names)
+			sum += transparentMap.find(std::string_view{ name })->second;
+
+		return sum;
+	};
+}
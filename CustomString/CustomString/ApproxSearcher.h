@@ -0,0 +1,320 @@
+#pragma once
+
+#include "CustomString.h"
+
+#include <cstdint> /* uint64_t */
+#include <vector> /* std::vector */
+#include <algorithm> /* std::sort(), std::unique(), std::lower_bound(), std::fill() */
+
+/* Approximate substring search: finds the needle with at most a given number of edits (insertions, deletions and substitutions).
+   Uses Myers' bit-parallel algorithm, which updates a column of the edit distance matrix 64 needle characters at a time,
+   so a search costs O(haystackSize * ceil(needleSize / 64)). The match masks are built once per needle.
+   Searching only reads the searcher, so one searcher can be shared between threads.
+   The column state lives on the stack for needles up to NrOfInlineBlocks * 64 characters, so those searches do not allocate */
+template<typename T>
+class ApproxSearcher final
+{
+public:
+	constexpr static size_t NoPos{ std::numeric_limits<size_t>::max() };
+
+#pragma region Ctors_Dtors
+
+	template<typename ... Ts>
+	explicit ApproxSearcher(const CustomString<T, Ts...>& needle);
+	explicit ApproxSearcher(const T* pNeedle);
+	ApproxSearcher(const T* pNeedle, const size_t count);
+
+#pragma endregion
+
+#pragma region Searching
+
+	/* Returns the match that ends first. The match is then extended for as long as that lowers the distance,
+	   so an exact occurrence is preferred over a shorter, approximate one that ends right before it.
+	   A needle of at most maxDistance characters can be deleted entirely, so it always gives the empty match at position 0
+	   with the needle size as its distance, without looking at the haystack */
+	template<typename ... Ts>
+	NODISCARD ApproxMatch FindIn(const CustomString<T, Ts...>& haystack, const size_t maxDistance) const;
+	NODISCARD ApproxMatch FindIn(const T* pHaystack, const size_t haystackSize, const size_t maxDistance) const;
+
+#pragma endregion
+
+#pragma region Searcher_Information
+
+	NODISCARD const CustomString<T>& GetNeedle() const;
+
+#pragma endregion
+
+private:
+	using Word = uint64_t;
+
+	constexpr static size_t WordBits{ 64 };
+	constexpr static size_t NrOfInlineBlocks{ 4 };
+	constexpr static Word HighBit{ Word{ 1 } << (WordBits - 1) };
+
+	/* Vertical deltas of one block of 64 rows: bit i of Pv (Mv) is set where row i is one more (less) than the row above */
+	struct Block final
+	{
+		Word Pv;
+		Word Mv;
+	};
+
+	void BuildMatchMasks();
+	NODISCARD size_t GetRow(const T c) const;
+	/* Advances a block by one haystack character. The carries are the horizontal deltas (-1, 0 or +1) of the row above the block and of its last row */
+	NODISCARD static int AdvanceBlock(Block& block, Word eq, const int carryIn, const Word lastBit);
+	void ResetBlocks(Block* pBlocks) const;
+	NODISCARD size_t Advance(Block* pBlocks, const std::vector<Word>& masks, const T c, const int carryIn, const size_t score) const;
+	NODISCARD size_t FindStart(Block* pBlocks, const T* pHaystack, const size_t end, const size_t distance) const;
+
+	CustomString<T> m_Needle;
+	std::vector<T> m_Alphabet; // Sorted needle characters, only used for characters wider than a byte
+	std::vector<Word> m_Masks; // m_NrOfBlocks words per character: bit i of word b is set where the needle has that character at b * 64 + i
+	std::vector<Word> m_ReversedMasks; // The same for the reversed needle
+	size_t m_NrOfBlocks;
+	Word m_LastBit; // Bit of the last needle character inside the last block
+};
+
+#pragma region Ctors_Dtors
+
+template<typename T>
+template<typename ... Ts>
+ApproxSearcher<T>::ApproxSearcher(const CustomString<T, Ts...>& needle)
+	: ApproxSearcher{ needle.Data(), needle.Size() }
+{}
+
+template<typename T>
+ApproxSearcher<T>::ApproxSearcher(const T* pNeedle)
+	: m_Needle{ pNeedle }
+	, m_Alphabet{}
+	, m_Masks{}
+	, m_ReversedMasks{}
+	, m_NrOfBlocks{}
+	, m_LastBit{}
+{
+	BuildMatchMasks();
+}
+
+template<typename T>
+ApproxSearcher<T>::ApproxSearcher(const T* pNeedle, const size_t count)
+	: m_Needle{}
+	, m_Alphabet{}
+	, m_Masks{}
+	, m_ReversedMasks{}
+	, m_NrOfBlocks{}
+	, m_LastBit{}
+{
+	/* Assign(pStr, count) would drop a trailing null character, the needle keeps all count characters */
+	m_Needle.ResizeAndOverwrite(count, [pNeedle](T* pData, const size_t size)
+		{
+			std::memcpy(pData, pNeedle, size * sizeof(T));
+			return size;
+		});
+
+	BuildMatchMasks();
+}
+
+#pragma endregion
+
+#pragma region Searching
+
+template<typename T>
+template<typename ... Ts>
+ApproxMatch ApproxSearcher<T>::FindIn(const CustomString<T, Ts...>& haystack, const size_t maxDistance) const
+{
+	return FindIn(haystack.Data(), haystack.Size(), maxDistance);
+}
+
+template<typename T>
+ApproxMatch ApproxSearcher<T>::FindIn(const T* pHaystack, const size_t haystackSize, const size_t maxDistance) const
+{
+	const size_t needleSize{ m_Needle.Size() };
+
+	/* Before any haystack character, the distance is the cost of deleting the entire needle */
+	if (needleSize <= maxDistance)
+		return ApproxMatch{ 0, 0, needleSize };
+
+	size_t score{ needleSize };
+	size_t distance{ score };
+	size_t end{};
+	bool found{};
+
+	/* The column state belongs to this search alone, the backward pass reuses it */
+	Block inlineBlocks[NrOfInlineBlocks];
+	std::vector<Block> heapBlocks{};
+	Block* pBlocks{ inlineBlocks };
+	if (m_NrOfBlocks > NrOfInlineBlocks)
+	{
+		heapBlocks.resize(m_NrOfBlocks);
+		pBlocks = heapBlocks.data();
+	}
+
+	ResetBlocks(pBlocks);
+
+	/* A match may start anywhere, so nothing is carried into the first block */
+	for (size_t i{}; i < haystackSize; ++i)
+	{
+		score = Advance(pBlocks, m_Masks, pHaystack[i], 0, score);
+
+		if (found)
+		{
+			if (score >= distance)
+				break;
+
+			distance = score;
+			end = i + 1;
+		}
+		else if (score <= maxDistance)
+		{
+			found = true;
+			distance = score;
+			end = i + 1;
+		}
+	}
+
+	if (!found)
+		return ApproxMatch{ NoPos, 0, 0 };
+
+	const size_t start{ FindStart(pBlocks, pHaystack, end, distance) };
+
+	return ApproxMatch{ start, end - start, distance };
+}
+
+#pragma endregion
+
+#pragma region Searcher_Information
+
+template<typename T>
+const CustomString<T>& ApproxSearcher<T>::GetNeedle() const
+{
+	return m_Needle;
+}
+
+#pragma endregion
+
+#pragma region Helpers
+
+template<typename T>
+void ApproxSearcher<T>::BuildMatchMasks()
+{
+	const size_t needleSize{ m_Needle.Size() };
+	const T* pNeedle{ m_Needle.Data() };
+
+	m_NrOfBlocks = needleSize == 0 ? 1 : (needleSize + WordBits - 1) / WordBits;
+	m_LastBit = Word{ 1 } << ((needleSize + WordBits - 1) % WordBits);
+
+	size_t nrOfRows{ 256 };
+	if constexpr (sizeof(T) != 1)
+	{
+		/* Row 0 is shared by every character that is not in the needle */
+		m_Alphabet.assign(pNeedle, pNeedle + needleSize);
+		std::sort(m_Alphabet.begin(), m_Alphabet.end());
+		m_Alphabet.erase(std::unique(m_Alphabet.begin(), m_Alphabet.end()), m_Alphabet.end());
+
+		nrOfRows = m_Alphabet.size() + 1;
+	}
+
+	m_Masks.assign(nrOfRows * m_NrOfBlocks, 0);
+	m_ReversedMasks.assign(nrOfRows * m_NrOfBlocks, 0);
+
+	for (size_t i{}; i < needleSize; ++i)
+	{
+		const size_t row{ GetRow(pNeedle[i]) * m_NrOfBlocks };
+		const size_t reversed{ needleSize - 1 - i };
+
+		m_Masks[row + i / WordBits] |= Word{ 1 } << (i % WordBits);
+		m_ReversedMasks[row + reversed / WordBits] |= Word{ 1 } << (reversed % WordBits);
+	}
+}
+
+template<typename T>
+size_t ApproxSearcher<T>::GetRow(const T c) const
+{
+	if constexpr (sizeof(T) == 1)
+	{
+		return static_cast<unsigned char>(c);
+	}
+	else
+	{
+		const auto it{ std::lower_bound(m_Alphabet.begin(), m_Alphabet.end(), c) };
+
+		return it != m_Alphabet.end() && *it == c ? static_cast<size_t>(it - m_Alphabet.begin()) + 1 : 0;
+	}
+}
+
+template<typename T>
+int ApproxSearcher<T>::AdvanceBlock(Block& block, Word eq, const int carryIn, const Word lastBit)
+{
+	const Word pv{ block.Pv };
+	const Word mv{ block.Mv };
+	const Word xv{ eq | mv };
+
+	if (carryIn < 0)
+		eq |= 1;
+
+	const Word xh{ (((eq & pv) + pv) ^ pv) | eq };
+	Word ph{ mv | ~(xh | pv) };
+	Word mh{ pv & xh };
+
+	int carryOut{};
+	if (ph & lastBit)
+		carryOut = 1;
+	else if (mh & lastBit)
+		carryOut = -1;
+
+	ph <<= 1;
+	mh <<= 1;
+
+	if (carryIn < 0)
+		mh |= 1;
+	else if (carryIn > 0)
+		ph |= 1;
+
+	block.Pv = mh | ~(xv | ph);
+	block.Mv = ph & xv;
+
+	return carryOut;
+}
+
+template<typename T>
+void ApproxSearcher<T>::ResetBlocks(Block* pBlocks) const
+{
+	std::fill(pBlocks, pBlocks + m_NrOfBlocks, Block{ ~Word{}, 0 });
+}
+
+template<typename T>
+size_t ApproxSearcher<T>::Advance(Block* pBlocks, const std::vector<Word>& masks, const T c, const int carryIn, const size_t score) const
+{
+	const Word* pEq{ masks.data() + GetRow(c) * m_NrOfBlocks };
+
+	int carry{ carryIn };
+	for (size_t b{}; b < m_NrOfBlocks; ++b)
+		carry = AdvanceBlock(pBlocks[b], pEq[b], carry, b + 1 == m_NrOfBlocks ? m_LastBit : HighBit);
+
+	/* The carry out of the last block is the change in distance at the last needle character */
+	return score + static_cast<size_t>(carry);
+}
+
+template<typename T>
+size_t ApproxSearcher<T>::FindStart(Block* pBlocks, const T* pHaystack, const size_t end, const size_t distance) const
+{
+	/* Searches backwards from the end with the reversed needle. Carrying +1 into the first block anchors the needle at the end,
+	   the score after i characters is then the distance between the needle and the i characters before the end */
+	size_t score{ m_Needle.Size() };
+	if (score == distance)
+		return end;
+
+	ResetBlocks(pBlocks);
+
+	for (size_t i{ 1 }; i <= end; ++i)
+	{
+		score = Advance(pBlocks, m_ReversedMasks, pHaystack[end - i], 1, score);
+
+		if (score == distance)
+			return end - i;
+	}
+
+	assert(false && "The forward search found a match that the backward search can not");
+	return 0;
+}
+
+#pragma endregion
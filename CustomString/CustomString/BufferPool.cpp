@@ -0,0 +1,245 @@
+#include "BufferPool.h"
+
+#include <new> /* ::operator new */
+#include <array> /* std::array */
+
+namespace
+{
+	/* The classes follow the same 1.5x steps as CustomString::CalculateNewCapacity(),
+	   rounded up to 16 bytes so every buffer stays suitably aligned */
+	constexpr size_t SizeClassGranularity{ 16 };
+	constexpr size_t SmallestSizeClass{ 32 };
+
+	constexpr std::array<size_t, BufferPool::NrOfSizeClasses> CalculateSizeClasses()
+	{
+		std::array<size_t, BufferPool::NrOfSizeClasses> sizeClasses{};
+
+		size_t size{ SmallestSizeClass };
+		for (size_t& sizeClass : sizeClasses)
+		{
+			sizeClass = size;
+
+			size += size / 2u;
+			size = (size + SizeClassGranularity - 1) & ~(SizeClassGranularity - 1);
+		}
+
+		return sizeClasses;
+	}
+
+	constexpr std::array<size_t, BufferPool::NrOfSizeClasses> SizeClasses{ CalculateSizeClasses() };
+
+	enum class ThreadPoolState : unsigned char
+	{
+		NotCreated,
+		Alive,
+		Destroyed
+	};
+
+	/* Trivially destructible, so it can still be read while the thread's other thread_locals and the statics are destroyed */
+	thread_local ThreadPoolState CurrentThreadPoolState{};
+
+	struct ThreadPool final
+	{
+		ThreadPool()
+		{
+			CurrentThreadPoolState = ThreadPoolState::Alive;
+		}
+
+		~ThreadPool()
+		{
+			CurrentThreadPoolState = ThreadPoolState::Destroyed;
+		}
+
+		BufferPool Pool{};
+	};
+}
+
+#pragma region Stats
+
+double BufferPool::Stats::HitRate() const
+{
+	const size_t total{ NrOfHits + NrOfMisses };
+
+	if (total == 0)
+		return 0.0;
+
+	return static_cast<double>(NrOfHits) / static_cast<double>(total);
+}
+
+#pragma endregion
+
+#pragma region Ctors_Dtors
+
+BufferPool::BufferPool(const size_t maxBuffersPerClass)
+	: m_pFreeLists{}
+	, m_FreeCounts{}
+	, m_MaxBuffersPerClass{ maxBuffersPerClass }
+	, m_Stats{}
+{}
+
+BufferPool::~BufferPool()
+{
+	Trim();
+}
+
+#pragma endregion
+
+#pragma region Allocation
+
+BufferPool& BufferPool::GetThreadLocal()
+{
+	assert(CurrentThreadPoolState != ThreadPoolState::Destroyed && "The pool of this thread has been destroyed already, use TryGetThreadLocal()");
+
+	thread_local ThreadPool threadPool{};
+
+	return threadPool.Pool;
+}
+
+BufferPool* BufferPool::TryGetThreadLocal()
+{
+	return CurrentThreadPoolState == ThreadPoolState::Destroyed ? nullptr : &GetThreadLocal();
+}
+
+BufferPool* BufferPool::FindThreadLocal()
+{
+	/* The state is checked first, so the pool object is only touched once it exists */
+	return CurrentThreadPoolState == ThreadPoolState::Alive ? &GetThreadLocal() : nullptr;
+}
+
+void* BufferPool::Allocate(const size_t size)
+{
+	const size_t classIndex{ GetClassIndex(size) };
+
+	if (classIndex == NrOfSizeClasses)
+	{
+		++m_Stats.NrOfMisses;
+		return ::operator new(size);
+	}
+
+	if (FreeBuffer* pBuffer{ m_pFreeLists[classIndex] }; pBuffer)
+	{
+		m_pFreeLists[classIndex] = pBuffer->pNext;
+		--m_FreeCounts[classIndex];
+		++m_Stats.NrOfHits;
+
+		return pBuffer;
+	}
+
+	++m_Stats.NrOfMisses;
+
+	return ::operator new(SizeClasses[classIndex]);
+}
+
+void BufferPool::Deallocate(void* pBuffer, const size_t size)
+{
+	if (!pBuffer)
+		return;
+
+	const size_t classIndex{ GetClassIndex(size) };
+
+	if (classIndex == NrOfSizeClasses || m_FreeCounts[classIndex] >= m_MaxBuffersPerClass)
+	{
+		++m_Stats.NrOfDropped;
+		::operator delete(pBuffer);
+		return;
+	}
+
+	FreeBuffer* pFreeBuffer{ static_cast<FreeBuffer*>(pBuffer) };
+	pFreeBuffer->pNext = m_pFreeLists[classIndex];
+
+	m_pFreeLists[classIndex] = pFreeBuffer;
+	++m_FreeCounts[classIndex];
+	++m_Stats.NrOfRecycled;
+}
+
+void BufferPool::Trim()
+{
+	for (size_t i{}; i < NrOfSizeClasses; ++i)
+	{
+		while (FreeBuffer* pBuffer{ m_pFreeLists[i] })
+		{
+			m_pFreeLists[i] = pBuffer->pNext;
+			::operator delete(pBuffer);
+		}
+
+		m_FreeCounts[i] = 0;
+	}
+}
+
+#pragma endregion
+
+#pragma region Pool_Information
+
+size_t BufferPool::RoundUp(const size_t size)
+{
+	const size_t classIndex{ GetClassIndex(size) };
+
+	return classIndex == NrOfSizeClasses ? size : SizeClasses[classIndex];
+}
+
+size_t BufferPool::GetClassSize(const size_t classIndex)
+{
+	assert(classIndex < NrOfSizeClasses);
+
+	return SizeClasses[classIndex];
+}
+
+size_t BufferPool::MaxPooledSize()
+{
+	return SizeClasses[NrOfSizeClasses - 1];
+}
+
+const BufferPool::Stats& BufferPool::GetStats() const
+{
+	return m_Stats;
+}
+
+void BufferPool::ResetStats()
+{
+	m_Stats = Stats{};
+}
+
+size_t BufferPool::BytesRetained() const
+{
+	size_t total{};
+
+	for (size_t i{}; i < NrOfSizeClasses; ++i)
+		total += m_FreeCounts[i] * SizeClasses[i];
+
+	return total;
+}
+
+void BufferPool::SetMaxBuffersPerClass(const size_t maxBuffersPerClass)
+{
+	m_MaxBuffersPerClass = maxBuffersPerClass;
+
+	/* Give back whatever no longer fits within the new bound */
+	for (size_t i{}; i < NrOfSizeClasses; ++i)
+	{
+		while (m_FreeCounts[i] > m_MaxBuffersPerClass)
+		{
+			FreeBuffer* pBuffer{ m_pFreeLists[i] };
+			m_pFreeLists[i] = pBuffer->pNext;
+			--m_FreeCounts[i];
+
+			::operator delete(pBuffer);
+		}
+	}
+}
+
+#pragma endregion
+
+#pragma region Helpers
+
+size_t BufferPool::GetClassIndex(const size_t size)
+{
+	/* Returns NrOfSizeClasses for sizes that are too large to be pooled */
+	size_t classIndex{};
+
+	while (classIndex < NrOfSizeClasses && SizeClasses[classIndex] < size)
+		++classIndex;
+
+	return classIndex;
+}
+
+#pragma endregion
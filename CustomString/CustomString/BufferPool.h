@@ -0,0 +1,125 @@
+#pragma once
+
+#include "CustomString.h"
+
+#include <type_traits> /* std::true_type */
+#include <new> /* ::operator new */
+
+/* Per-thread cache of string buffers, bucketed by size class.
+   Buffers released on a thread are handed out again by the next allocation of the same class on that thread. */
+class BufferPool final
+{
+public:
+	constexpr static size_t NrOfSizeClasses{ 20 };
+	constexpr static size_t DefaultMaxBuffersPerClass{ 32 };
+
+	struct Stats final
+	{
+		size_t NrOfHits; // Allocations served from a free list
+		size_t NrOfMisses; // Allocations that went to the global heap
+		size_t NrOfRecycled; // Deallocations kept in a free list
+		size_t NrOfDropped; // Deallocations returned to the global heap
+
+		NODISCARD double HitRate() const;
+	};
+
+#pragma region Ctors_Dtors
+
+	explicit BufferPool(const size_t maxBuffersPerClass = DefaultMaxBuffersPerClass);
+
+	~BufferPool();
+
+#pragma endregion
+
+#pragma region RuleOf5
+
+	BufferPool(const BufferPool&) noexcept = delete;
+	BufferPool(BufferPool&&) noexcept = delete;
+	BufferPool& operator=(const BufferPool&) noexcept = delete;
+	BufferPool& operator=(BufferPool&&) noexcept = delete;
+
+#pragma endregion
+
+#pragma region Allocation
+
+	NODISCARD static BufferPool& GetThreadLocal();
+	/* nullptr once the calling thread's pool has been destroyed during thread exit,
+	   for strings that outlive it such as other thread_locals or statics */
+	NODISCARD static BufferPool* TryGetThreadLocal();
+	/* nullptr unless the calling thread's pool is alive, never creates one.
+	   Releasing memory goes through this, so a thread that first frees a buffer during thread exit does not build a pool */
+	NODISCARD static BufferPool* FindThreadLocal();
+
+	NODISCARD void* Allocate(const size_t size);
+	void Deallocate(void* pBuffer, const size_t size);
+	void Trim();
+
+#pragma endregion
+
+#pragma region Pool_Information
+
+	NODISCARD static size_t RoundUp(const size_t size);
+	NODISCARD static size_t GetClassSize(const size_t classIndex);
+	NODISCARD static size_t MaxPooledSize();
+
+	NODISCARD const Stats& GetStats() const;
+	void ResetStats();
+	NODISCARD size_t BytesRetained() const;
+	void SetMaxBuffersPerClass(const size_t maxBuffersPerClass);
+
+#pragma endregion
+
+private:
+	struct FreeBuffer final
+	{
+		FreeBuffer* pNext;
+	};
+
+	NODISCARD static size_t GetClassIndex(const size_t size);
+
+	FreeBuffer* m_pFreeLists[NrOfSizeClasses];
+	size_t m_FreeCounts[NrOfSizeClasses];
+	size_t m_MaxBuffersPerClass;
+	Stats m_Stats;
+};
+
+/* Opt-in allocator that routes CustomString buffers through the calling thread's BufferPool */
+template<typename T>
+class PoolAllocator final
+{
+public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	PoolAllocator() noexcept = default;
+
+	template<typename U>
+	PoolAllocator(const PoolAllocator<U>&) noexcept
+	{}
+
+	/* Pooled buffers come from ::operator new, so the global heap can take over once the pool is gone */
+	NODISCARD T* allocate(const size_t n)
+	{
+		if (BufferPool* pPool{ BufferPool::TryGetThreadLocal() }; pPool)
+			return static_cast<T*>(pPool->Allocate(n * sizeof(T)));
+
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, const size_t n) noexcept
+	{
+		if (BufferPool* pPool{ BufferPool::FindThreadLocal() }; pPool)
+			pPool->Deallocate(p, n * sizeof(T));
+		else
+			::operator delete(p);
+	}
+
+	template<typename U>
+	NODISCARD bool operator==(const PoolAllocator<U>&) const
+	{
+		return true;
+	}
+};
+
+template<typename T>
+using PooledString = CustomString<T, PoolAllocator<T>>;
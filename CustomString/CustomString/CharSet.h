@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef> /* size_t */
+#include <array> /* std::array */
+#include <bit> /* std::popcount() */
+
+#ifndef NODISCARD
+#define NODISCARD [[nodiscard]]
+#endif
+
+/* Set of byte values, stored as a 256-bit bitmap.
+   The bits are laid out the way the SIMD nibble lookup wants them: byte c lives in entry ((c >> 7) << 4) | (c & 15),
+   at bit (c >> 4) & 7. The first 16 entries cover the high nibbles 0-7, the last 16 entries the high nibbles 8-15 */
+class CharSet final
+{
+public:
+	using Bitmap = std::array<unsigned char, 32>;
+
+#pragma region Ctors_Dtors
+
+	constexpr CharSet() = default;
+	constexpr explicit CharSet(const char* pChars);
+
+#pragma endregion
+
+#pragma region Modifiers
+
+	constexpr CharSet& Add(const unsigned char c);
+	constexpr CharSet& Add(const char* pChars);
+	constexpr CharSet& AddRange(const unsigned char first, const unsigned char last);
+	constexpr CharSet& Remove(const unsigned char c);
+	NODISCARD constexpr CharSet Complement() const;
+
+#pragma endregion
+
+#pragma region Set_Information
+
+	NODISCARD constexpr bool Contains(const unsigned char c) const;
+	NODISCARD constexpr size_t Count() const;
+	NODISCARD constexpr const Bitmap& GetBitmap() const;
+
+#pragma endregion
+
+private:
+	NODISCARD constexpr static size_t GetIndex(const unsigned char c);
+	NODISCARD constexpr static unsigned char GetBit(const unsigned char c);
+
+	Bitmap m_Bitmap{};
+};
+
+#pragma region Ctors_Dtors
+
+constexpr CharSet::CharSet(const char* pChars)
+{
+	Add(pChars);
+}
+
+#pragma endregion
+
+#pragma region Modifiers
+
+constexpr CharSet& CharSet::Add(const unsigned char c)
+{
+	m_Bitmap[GetIndex(c)] |= GetBit(c);
+
+	return *this;
+}
+
+constexpr CharSet& CharSet::Add(const char* pChars)
+{
+	for (; *pChars != '\0'; ++pChars)
+		Add(static_cast<unsigned char>(*pChars));
+
+	return *this;
+}
+
+constexpr CharSet& CharSet::AddRange(const unsigned char first, const unsigned char last)
+{
+	for (unsigned c{ first }; c <= last; ++c)
+		Add(static_cast<unsigned char>(c));
+
+	return *this;
+}
+
+constexpr CharSet& CharSet::Remove(const unsigned char c)
+{
+	m_Bitmap[GetIndex(c)] &= static_cast<unsigned char>(~GetBit(c));
+
+	return *this;
+}
+
+constexpr CharSet CharSet::Complement() const
+{
+	CharSet complement{};
+
+	for (size_t i{}; i < m_Bitmap.size(); ++i)
+		complement.m_Bitmap[i] = static_cast<unsigned char>(~m_Bitmap[i]);
+
+	return complement;
+}
+
+#pragma endregion
+
+#pragma region Set_Information
+
+constexpr bool CharSet::Contains(const unsigned char c) const
+{
+	return (m_Bitmap[GetIndex(c)] & GetBit(c)) != 0;
+}
+
+constexpr size_t CharSet::Count() const
+{
+	size_t count{};
+
+	for (const unsigned char bits : m_Bitmap)
+		count += static_cast<size_t>(std::popcount(bits));
+
+	return count;
+}
+
+constexpr const CharSet::Bitmap& CharSet::GetBitmap() const
+{
+	return m_Bitmap;
+}
+
+#pragma endregion
+
+#pragma region Helpers
+
+constexpr size_t CharSet::GetIndex(const unsigned char c)
+{
+	return static_cast<size_t>(((c >> 7) << 4) | (c & 15));
+}
+
+constexpr unsigned char CharSet::GetBit(const unsigned char c)
+{
+	return static_cast<unsigned char>(1u << ((c >> 4) & 7));
+}
+
+#pragma endregion
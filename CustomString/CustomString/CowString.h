@@ -0,0 +1,514 @@
+#pragma once
+
+#include "CustomString.h"
+
+#include <atomic> /* std::atomic */
+#include <utility> /* std::as_const() */
+
+/* Copy-on-write string: copies share one reference counted CustomString until either of them gets modified.
+   The reference count is atomic, so copies can be handed to other threads. */
+template<typename T, typename Alloc = std::allocator<T>, typename GrowthPolicy = GrowOnePointFive>
+class CowString final
+{
+public:
+	using StringType = CustomString<T, Alloc, GrowthPolicy>;
+
+	constexpr static size_t NoPos{ StringType::NoPos };
+
+#pragma region Ctors_Dtors
+
+	CowString() = default;
+	explicit CowString(const Alloc& alloc);
+	CowString(const T c, const size_t count, const Alloc& alloc = Alloc());
+	explicit CowString(const T* pStr, const Alloc& alloc = Alloc());
+	explicit CowString(StringType str);
+
+	~CowString();
+
+#pragma endregion
+
+#pragma region RuleOf5
+
+	CowString(const CowString& other) noexcept;
+	CowString(CowString&& other) noexcept;
+	CowString& operator=(const CowString& other) noexcept;
+	CowString& operator=(CowString&& other) noexcept;
+
+#pragma endregion
+
+#pragma region Adding_Chars
+
+	CowString& Assign(const T c, const size_t count);
+	CowString& Assign(const T* pStr);
+	CowString& Assign(const T* pStr, size_t count);
+	CowString& Append(const T c, const size_t count);
+	CowString& operator+=(const T* pStr);
+	CowString& operator+=(const CowString& other);
+
+#pragma endregion
+
+#pragma region String_Information
+
+	NODISCARD size_t Size() const;
+	NODISCARD size_t Capacity() const;
+	NODISCARD const T* Data() const;
+	NODISCARD size_t UseCount() const;
+	NODISCARD const StringType& GetString() const;
+
+#pragma endregion
+
+#pragma region Comparison
+
+	NODISCARD bool operator==(const CowString& other) const;
+	NODISCARD bool operator==(const T* pStr) const;
+
+#pragma endregion
+
+#pragma region String_Manipulation
+
+	CowString& ToUpper();
+	CowString& ToLower();
+
+#pragma endregion
+
+#pragma region Element_Access
+
+	NODISCARD T& operator[](const size_t index);
+	NODISCARD const T& operator[](const size_t index) const;
+
+#pragma endregion
+
+#pragma region Utility
+
+	NODISCARD CowString Substring(const size_t start, const size_t count = std::numeric_limits<size_t>::max()) const;
+	NODISCARD bool StartsWith(const CowString& str) const;
+	NODISCARD bool StartsWith(const T* pStr) const;
+	NODISCARD bool EndsWith(const CowString& str) const;
+	NODISCARD bool EndsWith(const T* pStr) const;
+	NODISCARD size_t IndexOf(const T c) const;
+	NODISCARD size_t IndexOf(const CowString& str) const;
+	NODISCARD size_t IndexOf(const T* pStr) const;
+	NODISCARD bool Contains(const T c) const;
+	NODISCARD bool Contains(const CowString& str) const;
+	NODISCARD bool Contains(const T* pStr) const;
+
+#pragma endregion
+
+private:
+	struct SharedBlock final
+	{
+		explicit SharedBlock(StringType&& str)
+			: String{ std::move(str) }
+			, RefCount{ 1 }
+			, IsShareable{ true }
+		{}
+
+		StringType String;
+		std::atomic<size_t> RefCount;
+		bool IsShareable; // Cleared once a mutable reference into String has been handed out, set again once that reference is dead
+	};
+
+	using BlockAllocator = typename std::allocator_traits<Alloc>::template rebind_alloc<SharedBlock>;
+	using BlockTraits = std::allocator_traits<BlockAllocator>;
+
+#pragma region Sharing
+
+	NODISCARD static SharedBlock* CreateBlock(StringType&& str);
+	static void ReleaseBlock(SharedBlock* pBlock);
+	StringType& Detach();
+	StringType& DetachForOverwrite();
+	/* References handed out by operator[] end when the contents are assigned anew or the buffer they point into is replaced */
+	void ResetShareable(const T* pOldData);
+
+#pragma endregion
+
+	SharedBlock* m_pBlock{};
+};
+
+#pragma region Ctors_Dtors
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>::CowString(const Alloc& alloc)
+	: m_pBlock{ CreateBlock(StringType{ alloc }) }
+{}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>::CowString(const T c, const size_t count, const Alloc& alloc)
+	: m_pBlock{ CreateBlock(StringType{ c, count, alloc }) }
+{}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>::CowString(const T* pStr, const Alloc& alloc)
+	: m_pBlock{ CreateBlock(StringType{ pStr, alloc }) }
+{}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>::CowString(StringType str)
+	: m_pBlock{ CreateBlock(std::move(str)) }
+{}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>::~CowString()
+{
+	ReleaseBlock(m_pBlock);
+}
+
+#pragma endregion
+
+#pragma region RuleOf5
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>::CowString(const CowString& other) noexcept
+	: m_pBlock{ other.m_pBlock }
+{
+	if (!m_pBlock)
+		return;
+
+	/* Someone might still be holding on to a mutable reference into this buffer, so it cannot be shared anymore */
+	if (!m_pBlock->IsShareable)
+		m_pBlock = CreateBlock(StringType{ m_pBlock->String });
+	else
+		m_pBlock->RefCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>::CowString(CowString&& other) noexcept
+	: m_pBlock{ other.m_pBlock }
+{
+	other.m_pBlock = nullptr;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>& CowString<T, Alloc, GrowthPolicy>::operator=(const CowString& other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	CowString copy{ other };
+	std::swap(m_pBlock, copy.m_pBlock);
+
+	return *this;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>& CowString<T, Alloc, GrowthPolicy>::operator=(CowString&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	ReleaseBlock(m_pBlock);
+
+	m_pBlock = other.m_pBlock;
+	other.m_pBlock = nullptr;
+
+	return *this;
+}
+
+#pragma endregion
+
+#pragma region Adding_Chars
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>& CowString<T, Alloc, GrowthPolicy>::Assign(const T c, const size_t count)
+{
+	DetachForOverwrite().Assign(c, count);
+	m_pBlock->IsShareable = true;
+
+	return *this;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>& CowString<T, Alloc, GrowthPolicy>::Assign(const T* pStr)
+{
+	DetachForOverwrite().Assign(pStr);
+	m_pBlock->IsShareable = true;
+
+	return *this;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>& CowString<T, Alloc, GrowthPolicy>::Assign(const T* pStr, size_t count)
+{
+	DetachForOverwrite().Assign(pStr, count);
+	m_pBlock->IsShareable = true;
+
+	return *this;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>& CowString<T, Alloc, GrowthPolicy>::Append(const T c, const size_t count)
+{
+	StringType& string{ Detach() };
+	const T* pOldData{ std::as_const(string).Data() };
+
+	string.Append(c, count);
+	ResetShareable(pOldData);
+
+	return *this;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>& CowString<T, Alloc, GrowthPolicy>::operator+=(const T* pStr)
+{
+	StringType& string{ Detach() };
+	const T* pOldData{ std::as_const(string).Data() };
+
+	string += pStr;
+	ResetShareable(pOldData);
+
+	return *this;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>& CowString<T, Alloc, GrowthPolicy>::operator+=(const CowString& other)
+{
+	/* Keep other's buffer alive, in case it is the one we are detaching from */
+	const CowString keepAlive{ other };
+
+	StringType& string{ Detach() };
+	const T* pOldData{ std::as_const(string).Data() };
+
+	string += keepAlive.GetString();
+	ResetShareable(pOldData);
+
+	return *this;
+}
+
+#pragma endregion
+
+#pragma region String_Information
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+size_t CowString<T, Alloc, GrowthPolicy>::Size() const
+{
+	return GetString().Size();
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+size_t CowString<T, Alloc, GrowthPolicy>::Capacity() const
+{
+	return GetString().Capacity();
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+const T* CowString<T, Alloc, GrowthPolicy>::Data() const
+{
+	return GetString().Data();
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+size_t CowString<T, Alloc, GrowthPolicy>::UseCount() const
+{
+	return m_pBlock ? m_pBlock->RefCount.load(std::memory_order_relaxed) : 0u;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+const typename CowString<T, Alloc, GrowthPolicy>::StringType& CowString<T, Alloc, GrowthPolicy>::GetString() const
+{
+	static const StringType empty{};
+
+	return m_pBlock ? m_pBlock->String : empty;
+}
+
+#pragma endregion
+
+#pragma region Comparison
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+bool CowString<T, Alloc, GrowthPolicy>::operator==(const CowString& other) const
+{
+	if (m_pBlock == other.m_pBlock)
+		return true;
+
+	return GetString() == other.GetString();
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+bool CowString<T, Alloc, GrowthPolicy>::operator==(const T* pStr) const
+{
+	return GetString() == pStr;
+}
+
+#pragma endregion
+
+#pragma region String_Manipulation
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>& CowString<T, Alloc, GrowthPolicy>::ToUpper()
+{
+	Detach().ToUpper();
+
+	return *this;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy>& CowString<T, Alloc, GrowthPolicy>::ToLower()
+{
+	Detach().ToLower();
+
+	return *this;
+}
+
+#pragma endregion
+
+#pragma region Element_Access
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+T& CowString<T, Alloc, GrowthPolicy>::operator[](const size_t index)
+{
+	StringType& string{ Detach() };
+
+	/* The returned reference outlives this call, so later copies have to get their own buffer */
+	m_pBlock->IsShareable = false;
+
+	return string[index];
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+const T& CowString<T, Alloc, GrowthPolicy>::operator[](const size_t index) const
+{
+	return GetString()[index];
+}
+
+#pragma endregion
+
+#pragma region Utility
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+CowString<T, Alloc, GrowthPolicy> CowString<T, Alloc, GrowthPolicy>::Substring(const size_t start, const size_t count) const
+{
+	return CowString{ GetString().Substring(start, count) };
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+bool CowString<T, Alloc, GrowthPolicy>::StartsWith(const CowString& str) const
+{
+	return GetString().StartsWith(str.GetString());
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+bool CowString<T, Alloc, GrowthPolicy>::StartsWith(const T* pStr) const
+{
+	return GetString().StartsWith(pStr);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+bool CowString<T, Alloc, GrowthPolicy>::EndsWith(const CowString& str) const
+{
+	return GetString().EndsWith(str.GetString());
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+bool CowString<T, Alloc, GrowthPolicy>::EndsWith(const T* pStr) const
+{
+	return GetString().EndsWith(pStr);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+size_t CowString<T, Alloc, GrowthPolicy>::IndexOf(const T c) const
+{
+	return GetString().IndexOf(c);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+size_t CowString<T, Alloc, GrowthPolicy>::IndexOf(const CowString& str) const
+{
+	return GetString().IndexOf(str.GetString());
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+size_t CowString<T, Alloc, GrowthPolicy>::IndexOf(const T* pStr) const
+{
+	return GetString().IndexOf(pStr);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+bool CowString<T, Alloc, GrowthPolicy>::Contains(const T c) const
+{
+	return GetString().Contains(c);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+bool CowString<T, Alloc, GrowthPolicy>::Contains(const CowString& str) const
+{
+	return GetString().Contains(str.GetString());
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+bool CowString<T, Alloc, GrowthPolicy>::Contains(const T* pStr) const
+{
+	return GetString().Contains(pStr);
+}
+
+#pragma endregion
+
+#pragma region Sharing
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+typename CowString<T, Alloc, GrowthPolicy>::SharedBlock* CowString<T, Alloc, GrowthPolicy>::CreateBlock(StringType&& str)
+{
+	BlockAllocator alloc{ str.GetAllocator() };
+
+	SharedBlock* pBlock{ BlockTraits::allocate(alloc, 1) };
+	BlockTraits::construct(alloc, pBlock, std::move(str));
+
+	return pBlock;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+void CowString<T, Alloc, GrowthPolicy>::ReleaseBlock(SharedBlock* pBlock)
+{
+	if (!pBlock)
+		return;
+
+	/* The last owner has to see every write the other owners made before letting go */
+	if (pBlock->RefCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return;
+
+	BlockAllocator alloc{ pBlock->String.GetAllocator() };
+
+	BlockTraits::destroy(alloc, pBlock);
+	BlockTraits::deallocate(alloc, pBlock, 1);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+typename CowString<T, Alloc, GrowthPolicy>::StringType& CowString<T, Alloc, GrowthPolicy>::Detach()
+{
+	if (!m_pBlock)
+	{
+		m_pBlock = CreateBlock(StringType{});
+	}
+	else if (m_pBlock->RefCount.load(std::memory_order_acquire) != 1)
+	{
+		SharedBlock* pOldBlock{ m_pBlock };
+
+		m_pBlock = CreateBlock(StringType{ pOldBlock->String });
+		ReleaseBlock(pOldBlock);
+	}
+
+	return m_pBlock->String;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+typename CowString<T, Alloc, GrowthPolicy>::StringType& CowString<T, Alloc, GrowthPolicy>::DetachForOverwrite()
+{
+	/* Same as Detach(), minus copying contents that are about to be replaced anyway */
+	if (m_pBlock && m_pBlock->RefCount.load(std::memory_order_acquire) != 1)
+	{
+		SharedBlock* pOldBlock{ m_pBlock };
+
+		m_pBlock = CreateBlock(StringType{ pOldBlock->String.GetAllocator() });
+		ReleaseBlock(pOldBlock);
+	}
+
+	return Detach();
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy>
+void CowString<T, Alloc, GrowthPolicy>::ResetShareable(const T* pOldData)
+{
+	if (std::as_const(m_pBlock->String).Data() != pOldData)
+		m_pBlock->IsShareable = true;
+}
+
+#pragma endregion
@@ -3,7 +3,15 @@
 #include <cstring> /* std::memcpy */
 #include <assert.h> /* assert() */
 #include <limits> /* std::numeric_limits */
-#include <utility> /* std::move() */
+#include <utility> /* std::move(), std::as_const() */
+#include <type_traits> /* std::is_trivially_copyable_v */
+#include <algorithm> /* std::min() */
+#include <functional> /* std::less, std::hash */
+#include <memory> /* std::allocator, std::allocator_traits */
+#include <memory_resource> /* std::pmr::polymorphic_allocator */
+#include <bit> /* std::bit_ceil() */
+#include <iterator> /* std::default_sentinel_t, std::forward_iterator_tag */
+#include <compare> /* std::strong_ordering */
 
 #ifdef max
 #undef max
@@ -11,17 +19,243 @@
 
 #define NODISCARD [[nodiscard]]
 
+#ifdef _MSC_VER
+#define NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+#include "StringSearch.h"
+#include "StringHash.h"
+
+#pragma region Growth_Policies
+
+/* Growth policies decide the new capacity (in elements, null-terminator included) whenever a string outgrows its buffer */
+
+struct GrowOnePointFive final
+{
+	template<typename T>
+	NODISCARD constexpr static size_t CalculateNewCapacity(const size_t oldCap, const size_t min, const size_t maxCap)
+	{
+		if (oldCap > maxCap - oldCap / 2u)
+			return maxCap;
+
+		const size_t newCap{ oldCap + oldCap / 2u };
+
+		// If our growth is insufficient, return just the bare minimum
+		return newCap < min ? min : newCap;
+	}
+};
+
+struct GrowDouble final
+{
+	template<typename T>
+	NODISCARD constexpr static size_t CalculateNewCapacity(const size_t oldCap, const size_t min, const size_t maxCap)
+	{
+		if (oldCap > maxCap / 2u)
+			return maxCap;
+
+		const size_t newCap{ oldCap * 2u };
+
+		return newCap < min ? min : newCap;
+	}
+};
+
+struct GrowExact final
+{
+	template<typename T>
+	NODISCARD constexpr static size_t CalculateNewCapacity(const size_t, const size_t min, const size_t)
+	{
+		return min;
+	}
+};
+
+struct GrowPowerOfTwo final
+{
+	template<typename T>
+	NODISCARD constexpr static size_t CalculateNewCapacity(const size_t, const size_t min, const size_t maxCap)
+	{
+		if (min > maxCap / 2u + 1u)
+			return maxCap;
+
+		return std::bit_ceil(min);
+	}
+};
+
+/* Size classes in the style of common malloc implementations:
+   16 byte steps up to 128 bytes, four classes per power of two after that */
+struct MallocSizeClasses final
+{
+	NODISCARD constexpr static size_t RoundUp(const size_t size)
+	{
+		if (size <= 128u)
+			return (size + 15u) & ~size_t(15u);
+
+		const size_t spacing{ std::bit_floor(size - 1u) / 4u };
+
+		if (size > std::numeric_limits<size_t>::max() - spacing)
+			return size;
+
+		return (size + spacing - 1u) & ~(spacing - 1u);
+	}
+};
+
+/* Grows by 1.5x and then rounds up to the allocator's size class, so the slack the allocator hands out anyway becomes usable capacity.
+   SizeClasses needs a static RoundUp(size_t bytes), e.g. BufferPool for PoolAllocator */
+template<typename SizeClasses = MallocSizeClasses>
+struct GrowToSizeClass final
+{
+	template<typename T>
+	NODISCARD constexpr static size_t CalculateNewCapacity(const size_t oldCap, const size_t min, const size_t maxCap)
+	{
+		const size_t newCap{ GrowOnePointFive::CalculateNewCapacity<T>(oldCap, min, maxCap) };
+
+		if (newCap > std::numeric_limits<size_t>::max() / sizeof(T))
+			return newCap;
+
+		const size_t roundedCap{ SizeClasses::RoundUp(newCap * sizeof(T)) / sizeof(T) };
+
+		return roundedCap < newCap || roundedCap > maxCap ? newCap : roundedCap;
+	}
+};
+
+#pragma endregion
+
+#pragma region Hash_Caches
+
+/* Hash caches decide whether Hash() remembers its result. Invalidate() is called whenever the string writes its characters,
+   Leak() when a writable pointer or reference is handed out and Reset() when the contents are replaced wholesale */
+struct NoHashCache final
+{
+	NODISCARD constexpr bool TryGet(size_t&) const { return false; }
+	constexpr void Store(const size_t) const {}
+	constexpr void Invalidate() {}
+	constexpr void Leak() {}
+	constexpr void Reset() {}
+};
+
+/* Hashes once and keeps the result next to the size, for keys that are hashed or compared over and over.
+   Writes through a pointer or reference from Data() or operator[] can not be seen, so handing one out stops the caching
+   until the string is assigned a new value. Hash() writes the cache, so a string whose cache is empty must not be hashed from several threads at once */
+struct CachedHash final
+{
+	NODISCARD constexpr bool TryGet(size_t& hash) const
+	{
+		hash = m_Hash;
+		return m_IsValid;
+	}
+
+	constexpr void Store(const size_t hash) const
+	{
+		if (m_IsLeaked)
+			return;
+
+		m_Hash = hash;
+		m_IsValid = true;
+	}
+
+	constexpr void Invalidate()
+	{
+		m_IsValid = false;
+	}
+
+	constexpr void Leak()
+	{
+		m_IsValid = false;
+		m_IsLeaked = true;
+	}
+
+	constexpr void Reset()
+	{
+		m_IsValid = false;
+		m_IsLeaked = false;
+	}
+
+private:
+	mutable size_t m_Hash{};
+	mutable bool m_IsValid{};
+	bool m_IsLeaked{}; // Sticky until Reset(), like CowString's shareable flag
+};
+
+#pragma endregion
+
+template<typename T>
+class Searcher;
 template<typename T>
+class ApproxSearcher;
+
+/* Result of an approximate search, see CustomString::IndexOfApprox() */
+struct ApproxMatch final
+{
+	size_t Position; // NoPos if nothing was within the maximum distance
+	size_t Size;
+	size_t Distance; // Edit distance between the needle and [Position, Position + Size)
+};
+
+template<typename T, typename Alloc = std::allocator<T>, typename GrowthPolicy = GrowOnePointFive, typename HashCache = NoHashCache>
 class CustomString final
 {
+	using AllocTraits = std::allocator_traits<Alloc>;
+
+	static_assert(std::is_trivially_copyable_v<T>, "CustomString<T> copies its characters with std::memcpy");
+	static_assert(std::is_same_v<typename AllocTraits::value_type, T>, "Alloc::value_type must be T");
+	static_assert(std::is_same_v<typename AllocTraits::pointer, T*>, "CustomString<T> does not support fancy pointers");
+
 public:
+	using AllocatorType = Alloc;
+
 	constexpr static size_t NoPos{ std::numeric_limits<size_t>::max() };
 
+	/* Yields the offset of every occurrence of a needle, from left to right.
+	   Neither the string nor the needle are copied, both have to outlive the iterator */
+	class FindIterator final
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = size_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = size_t;
+
+		FindIterator() = default;
+		FindIterator(const CustomString* pString, const T* pNeedle, const size_t needleSize, const bool overlapping);
+
+		NODISCARD size_t operator*() const;
+		FindIterator& operator++();
+		FindIterator operator++(int);
+
+		NODISCARD bool operator==(const FindIterator& other) const;
+		NODISCARD bool operator==(std::default_sentinel_t) const;
+
+	private:
+		const CustomString* m_pString{};
+		const T* m_pNeedle{};
+		size_t m_NeedleSize{};
+		size_t m_Position{ NoPos }; // Offset of the current match, NoPos once exhausted
+		bool m_Overlapping{};
+	};
+
+	class FindRange final
+	{
+	public:
+		FindRange(const CustomString* pString, const T* pNeedle, const size_t needleSize, const bool overlapping);
+
+		NODISCARD FindIterator begin() const;
+		NODISCARD std::default_sentinel_t end() const;
+
+	private:
+		const CustomString* m_pString;
+		const T* m_pNeedle;
+		size_t m_NeedleSize;
+		bool m_Overlapping;
+	};
+
 #pragma region Ctors_Dtors
 
 	CustomString() = default;
-	CustomString(const T c, const size_t count);
-	explicit CustomString(const T* pStr);
+	explicit CustomString(const Alloc& alloc);
+	CustomString(const T c, const size_t count, const Alloc& alloc = Alloc());
+	explicit CustomString(const T* pStr, const Alloc& alloc = Alloc());
 
 	~CustomString();
 
@@ -30,10 +264,14 @@ public:
 #pragma region RuleOf5
 
 	CustomString(const CustomString& other) noexcept;
+	CustomString(const CustomString& other, const Alloc& alloc) noexcept;
 	CustomString(CustomString&& other) noexcept;
+	CustomString(CustomString&& other, const Alloc& alloc) noexcept;
 	CustomString& operator=(const CustomString& other) noexcept;
 	CustomString& operator=(CustomString&& other) noexcept;
 
+	void Swap(CustomString& other) noexcept;
+
 #pragma endregion
 
 #pragma region Adding_Chars
@@ -43,7 +281,17 @@ public:
 	CustomString& Assign(const T* pStr, size_t count);
 	CustomString& Append(const T c, const size_t count);
 	CustomString& operator+=(const T* pStr);
-	CustomString& operator+=(const CustomString<T>& other);
+	CustomString& operator+=(const CustomString& other);
+
+#pragma endregion
+
+#pragma region Capacity
+
+	void Reserve(const size_t size);
+	void ShrinkToFit();
+	void ResizeUninitialized(const size_t size);
+	template<typename Operation>
+	CustomString& ResizeAndOverwrite(const size_t size, Operation op);
 
 #pragma endregion
 
@@ -52,7 +300,13 @@ public:
 	NODISCARD size_t Size() const;
 	NODISCARD size_t Capacity() const;
 	NODISCARD size_t MaxSize() const;
+	NODISCARD T* Data();
 	NODISCARD const T* Data() const;
+	NODISCARD Alloc GetAllocator() const;
+	/* Hash of the characters, equal contents give equal hashes regardless of Alloc, GrowthPolicy and HashCache.
+	   With CachedHash the result is kept until the next writable access */
+	NODISCARD size_t Hash() const;
+	NODISCARD size_t Hash(const uint64_t seed) const;
 
 #pragma endregion
 
@@ -60,6 +314,13 @@ public:
 
 	NODISCARD bool operator==(const CustomString& other) const;
 	NODISCARD bool operator==(const T* pStr) const;
+	/* Lexicographic by code unit, a prefix orders before the longer string */
+	NODISCARD std::strong_ordering operator<=>(const CustomString& other) const;
+	NODISCARD std::strong_ordering operator<=>(const T* pStr) const;
+	template<typename Fold = StringSearch::AsciiCaseFold>
+	NODISCARD bool EqualsIgnoreCase(const CustomString& other) const;
+	template<typename Fold = StringSearch::AsciiCaseFold>
+	NODISCARD bool EqualsIgnoreCase(const T* pStr) const;
 
 #pragma endregion
 
@@ -80,16 +341,49 @@ public:
 #pragma region Utility
 
 	NODISCARD CustomString Substring(const size_t start, const size_t count = std::numeric_limits<size_t>::max()) const;
-	NODISCARD bool StartsWith(const CustomString<T>& str) const;
+	NODISCARD bool StartsWith(const CustomString& str) const;
 	NODISCARD bool StartsWith(const T* pStr) const;
-	NODISCARD bool EndsWith(const CustomString<T>& str) const;
+	NODISCARD bool EndsWith(const CustomString& str) const;
 	NODISCARD bool EndsWith(const T* pStr) const;
 	NODISCARD size_t IndexOf(const T c) const;
-	NODISCARD size_t IndexOf(const CustomString<T>& str) const;
+	NODISCARD size_t IndexOf(const CustomString& str) const;
 	NODISCARD size_t IndexOf(const T* pStr) const;
+	NODISCARD size_t IndexOf(const Searcher<T>& searcher) const;
+	/* First match within maxDistance edits, see ApproxSearcher::FindIn(). A needle of at most maxDistance characters gives the empty match at 0 */
+	NODISCARD ApproxMatch IndexOfApprox(const CustomString& str, const size_t maxDistance) const;
+	NODISCARD ApproxMatch IndexOfApprox(const T* pStr, const size_t maxDistance) const;
+	NODISCARD ApproxMatch IndexOfApprox(const ApproxSearcher<T>& searcher, const size_t maxDistance) const;
+	NODISCARD size_t LastIndexOf(const T c) const;
+	NODISCARD size_t LastIndexOf(const CustomString& str) const;
+	NODISCARD size_t LastIndexOf(const T* pStr) const;
+	NODISCARD size_t IndexOfAny(const CharSet& set) const;
+	NODISCARD size_t IndexOfNotAny(const CharSet& set) const;
+	NODISCARD size_t Span(const CharSet& set) const;
+	NODISCARD size_t ComplementSpan(const CharSet& set) const;
 	NODISCARD bool Contains(const T c) const;
-	NODISCARD bool Contains(const CustomString<T>& str) const;
+	NODISCARD bool Contains(const CustomString& str) const;
 	NODISCARD bool Contains(const T* pStr) const;
+	NODISCARD size_t Count(const CustomString& str, const bool overlapping = false) const;
+	NODISCARD size_t Count(const T* pStr, const bool overlapping = false) const;
+	/* The range points into this string and into the needle, both have to outlive it. Temporary needles are rejected for that reason */
+	NODISCARD FindRange FindAll(const CustomString& str, const bool overlapping = false) const;
+	NODISCARD FindRange FindAll(const T* pStr, const bool overlapping = false) const;
+	FindRange FindAll(CustomString&& str, const bool overlapping = false) const = delete;
+
+	/* Case-insensitive versions of the above, nothing is copied or modified.
+	   Fold decides which characters are equal, see StringSearch::AsciiCaseFold */
+	template<typename Fold = StringSearch::AsciiCaseFold>
+	NODISCARD bool StartsWithIgnoreCase(const CustomString& str) const;
+	template<typename Fold = StringSearch::AsciiCaseFold>
+	NODISCARD bool StartsWithIgnoreCase(const T* pStr) const;
+	template<typename Fold = StringSearch::AsciiCaseFold>
+	NODISCARD bool EndsWithIgnoreCase(const CustomString& str) const;
+	template<typename Fold = StringSearch::AsciiCaseFold>
+	NODISCARD bool EndsWithIgnoreCase(const T* pStr) const;
+	template<typename Fold = StringSearch::AsciiCaseFold>
+	NODISCARD size_t IndexOfIgnoreCase(const CustomString& str) const;
+	template<typename Fold = StringSearch::AsciiCaseFold>
+	NODISCARD size_t IndexOfIgnoreCase(const T* pStr) const;
 
 #pragma endregion
 
@@ -97,51 +391,207 @@ private:
 #pragma region Reallocation
 
 	void Reallocate(const size_t min);
+	void ResizeBuffer(const size_t newCap);
 	NODISCARD constexpr size_t CalculateNewCapacity(const size_t min) const;
-	constexpr void Release(T*& pData);
-	constexpr void DeleteData(T* head, T* const tail) const;
+	NODISCARD T* Allocate(const size_t cap);
+	constexpr void Release(T*& pData, const size_t cap);
+	void ReleaseStorage();
+	constexpr void DeleteData(T* head, T* const tail);
+
+#pragma endregion
+
+#pragma region Small_String
+
+	NODISCARD bool IsSmall() const;
+	/* Writable characters for the string's own mutators, which invalidate the hash cache without leaking it */
+	NODISCARD T* MutableData();
+	void SetSize(const size_t size);
+	void SetEmpty();
+	void AssignRaw(const T* pStr, const size_t count);
+	void AppendRaw(const T* pStr, const size_t count);
+	void CopyFrom(const CustomString& other);
+	void StealFrom(CustomString& other);
 
 #pragma endregion
 
 #pragma region Helpers
 
 	NODISCARD size_t CountRawString(const T* const pStr) const;
+	NODISCARD constexpr static std::strong_ordering CompareCodeUnits(const T a, const T b);
+	NODISCARD size_t IndexOfRaw(const T* pStr, const size_t count, const size_t start = 0) const;
+	NODISCARD size_t LastIndexOfRaw(const T* pStr, const size_t count) const;
+	NODISCARD size_t IndexOfInSet(const CharSet& set, const bool inSet) const;
+	template<typename Fold>
+	NODISCARD static bool EqualsIgnoreCaseRaw(const T* pA, const T* pB, const size_t count);
+	template<typename Fold>
+	NODISCARD bool StartsWithIgnoreCaseRaw(const T* pStr, const size_t count) const;
+	template<typename Fold>
+	NODISCARD bool EndsWithIgnoreCaseRaw(const T* pStr, const size_t count) const;
+	template<typename Fold>
+	NODISCARD size_t IndexOfIgnoreCaseRaw(const T* pStr, const size_t count) const;
 
 #pragma endregion
 
-	T* m_pHead;
-	T* m_pTail;
-	T* m_pCurrentEnd; // Points past the end
-	size_t m_Size;
+	struct HeapData final
+	{
+		T* pHead; // nullptr while the string is empty
+		size_t Capacity;
+	};
+
+	/* Amount of characters (null-terminator included) that fit inside the object itself */
+	constexpr static size_t SmallCapacity{ sizeof(HeapData) / sizeof(T) };
+
+	/* The top bit of m_Size marks m_Buffer as the active storage */
+	constexpr static size_t SmallFlag{ size_t(1) << (std::numeric_limits<size_t>::digits - 1) };
+
+	union
+	{
+		HeapData m_Heap{};
+		T m_Buffer[SmallCapacity];
+	};
+	size_t m_Size{};
+	NO_UNIQUE_ADDRESS HashCache m_HashCache{};
+	NO_UNIQUE_ADDRESS Alloc m_Alloc{};
 };
 
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void swap(CustomString<T, Alloc, GrowthPolicy, HashCache>& a, CustomString<T, Alloc, GrowthPolicy, HashCache>& b) noexcept
+{
+	a.Swap(b);
+}
+
+namespace pmr
+{
+	template<typename T, typename GrowthPolicy = GrowOnePointFive, typename HashCache = NoHashCache>
+	using CustomString = ::CustomString<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy, HashCache>;
+}
+
+namespace std
+{
+	template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+	struct hash<CustomString<T, Alloc, GrowthPolicy, HashCache>>
+	{
+		NODISCARD size_t operator()(const CustomString<T, Alloc, GrowthPolicy, HashCache>& str) const
+		{
+			return str.Hash();
+		}
+	};
+}
+
+#pragma region FindIterator
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>::FindIterator::FindIterator(const CustomString* pString, const T* pNeedle, const size_t needleSize, const bool overlapping)
+	: m_pString{ pString }
+	, m_pNeedle{ pNeedle }
+	, m_NeedleSize{ needleSize }
+	, m_Position{ NoPos }
+	, m_Overlapping{ overlapping }
+{
+	/* An empty needle would match everywhere without ever advancing, so it yields nothing */
+	if (needleSize != 0)
+		m_Position = pString->IndexOfRaw(pNeedle, needleSize);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::FindIterator::operator*() const
+{
+	assert(m_Position != NoPos);
+
+	return m_Position;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+typename CustomString<T, Alloc, GrowthPolicy, HashCache>::FindIterator& CustomString<T, Alloc, GrowthPolicy, HashCache>::FindIterator::operator++()
+{
+	assert(m_Position != NoPos);
+
+	/* Every search starts right after the previous match, or one character further when matches may overlap */
+	const size_t start{ m_Position + (m_Overlapping ? 1 : m_NeedleSize) };
+
+	if (start + m_NeedleSize > m_pString->Size())
+		m_Position = NoPos;
+	else
+		m_Position = m_pString->IndexOfRaw(m_pNeedle, m_NeedleSize, start);
+
+	return *this;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+typename CustomString<T, Alloc, GrowthPolicy, HashCache>::FindIterator CustomString<T, Alloc, GrowthPolicy, HashCache>::FindIterator::operator++(int)
+{
+	FindIterator copy{ *this };
+	++(*this);
+
+	return copy;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::FindIterator::operator==(const FindIterator& other) const
+{
+	if (m_Position == NoPos || other.m_Position == NoPos)
+		return m_Position == other.m_Position;
+
+	return m_pString == other.m_pString && m_Position == other.m_Position;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::FindIterator::operator==(std::default_sentinel_t) const
+{
+	return m_Position == NoPos;
+}
+
+#pragma endregion
+
+#pragma region FindRange
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>::FindRange::FindRange(const CustomString* pString, const T* pNeedle, const size_t needleSize, const bool overlapping)
+	: m_pString{ pString }
+	, m_pNeedle{ pNeedle }
+	, m_NeedleSize{ needleSize }
+	, m_Overlapping{ overlapping }
+{}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+typename CustomString<T, Alloc, GrowthPolicy, HashCache>::FindIterator CustomString<T, Alloc, GrowthPolicy, HashCache>::FindRange::begin() const
+{
+	return FindIterator{ m_pString, m_pNeedle, m_NeedleSize, m_Overlapping };
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+std::default_sentinel_t CustomString<T, Alloc, GrowthPolicy, HashCache>::FindRange::end() const
+{
+	return std::default_sentinel;
+}
+
+#pragma endregion
+
 #pragma region Ctors_Dtors
 
-template<typename T>
-CustomString<T>::CustomString(const T c, const size_t count)
-	: m_pHead{}
-	, m_pTail{}
-	, m_pCurrentEnd{}
-	, m_Size{}
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>::CustomString(const Alloc& alloc)
+	: m_Alloc{ alloc }
+{}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>::CustomString(const T c, const size_t count, const Alloc& alloc)
+	: m_Alloc{ alloc }
 {
 	Assign(c, count);
 }
 
-template<typename T>
-CustomString<T>::CustomString(const T* pStr)
-	: m_pHead{}
-	, m_pTail{}
-	, m_pCurrentEnd{}
-	, m_Size{}
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>::CustomString(const T* pStr, const Alloc& alloc)
+	: m_Alloc{ alloc }
 {
 	Assign(pStr);
 }
 
-template<typename T>
-CustomString<T>::~CustomString()
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>::~CustomString()
 {
-	DeleteData(m_pHead, m_pCurrentEnd);
-	Release(m_pHead);
+	ReleaseStorage();
 
 	m_Size = 0;
 }
@@ -150,194 +600,259 @@ CustomString<T>::~CustomString()
 
 #pragma region RuleOf5
 
-template<typename T>
-CustomString<T>::CustomString(const CustomString& other) noexcept
-	: m_pHead{}
-	, m_pTail{}
-	, m_pCurrentEnd{}
-	, m_Size{ other.m_Size }
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>::CustomString(const CustomString& other) noexcept
+	: m_Alloc{ AllocTraits::select_on_container_copy_construction(other.m_Alloc) }
 {
-	if (const uint64_t cap{ other.Capacity() }; cap > 0u)
-	{
-		m_pHead = new T[cap]{};
-		m_pTail = m_pHead + cap;
+	CopyFrom(other);
+}
 
-		const uint64_t size{ other.Size() };
-		std::memcpy(m_pHead, other.m_pHead, size);
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>::CustomString(const CustomString& other, const Alloc& alloc) noexcept
+	: m_Alloc{ alloc }
+{
+	CopyFrom(other);
+}
 
-		m_pCurrentEnd = m_pHead + size;
-	}
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>::CustomString(CustomString&& other) noexcept
+	: m_Alloc{ std::move(other.m_Alloc) }
+{
+	StealFrom(other);
 }
 
-template<typename T>
-CustomString<T>::CustomString(CustomString&& other) noexcept
-	: m_pHead{ std::move(other.m_pHead) }
-	, m_pTail{ std::move(other.m_pTail) }
-	, m_pCurrentEnd{ std::move(other.m_pCurrentEnd) }
-	, m_Size{ std::move(other.m_Size) }
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>::CustomString(CustomString&& other, const Alloc& alloc) noexcept
+	: m_Alloc{ alloc }
 {
-	other.m_pHead = nullptr;
-	other.m_pTail = nullptr;
-	other.m_pCurrentEnd = nullptr;
-	other.m_Size = 0;
+	/* A heap buffer can only change owners if our allocator is able to free it */
+	if (other.IsSmall() || m_Alloc == other.m_Alloc)
+		StealFrom(other);
+	else
+		CopyFrom(other);
 }
 
-template<typename T>
-CustomString<T>& CustomString<T>::operator=(const CustomString& other) noexcept
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>& CustomString<T, Alloc, GrowthPolicy, HashCache>::operator=(const CustomString& other) noexcept
 {
-	if (m_pHead)
+	if (this == &other)
+		return *this;
+
+	if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
 	{
-		DeleteData(m_pHead, m_pCurrentEnd);
-		Release(m_pHead);
-	}
+		if (m_Alloc != other.m_Alloc)
+		{
+			/* Our buffer has to be returned to the allocator that handed it out */
+			ReleaseStorage();
+			SetEmpty();
+		}
 
-	m_pHead = nullptr;
-	m_pTail = nullptr;
-	m_pCurrentEnd = nullptr;
-	m_Size = other.m_Size;
+		m_Alloc = other.m_Alloc;
+	}
 
-	if (const uint64_t cap{ other.Capacity() }; cap > 0u)
+	/* Reuse our own heap buffer if the contents do not fit inline but do fit in what we already own */
+	if (!IsSmall() && other.Size() >= SmallCapacity && other.Size() < Capacity())
 	{
-		m_pHead = new T[cap]{};
-		m_pTail = m_pHead + cap;
+		AssignRaw(other.Data(), other.Size());
+		return *this;
+	}
 
-		const uint64_t size{ other.Size() };
-		std::memcpy(m_pHead, other.m_pHead, size);
+	ReleaseStorage();
 
-		m_pCurrentEnd = m_pHead + size;
-	}
+	CopyFrom(other);
 
 	return *this;
 }
 
-template<typename T>
-CustomString<T>& CustomString<T>::operator=(CustomString&& other) noexcept
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>& CustomString<T, Alloc, GrowthPolicy, HashCache>::operator=(CustomString&& other) noexcept
 {
-	if (m_pHead)
+	if (this == &other)
+		return *this;
+
+	if constexpr (!AllocTraits::propagate_on_container_move_assignment::value)
 	{
-		DeleteData(m_pHead, m_pCurrentEnd);
-		Release(m_pHead);
+		/* Without propagation we can only take over buffers our own allocator is able to free */
+		if (!other.IsSmall() && m_Alloc != other.m_Alloc)
+		{
+			ReleaseStorage();
+			CopyFrom(other);
+			return *this;
+		}
 	}
 
-	m_pHead = std::move(other.m_pHead);
-	m_pTail = std::move(other.m_pTail);
-	m_pCurrentEnd = std::move(other.m_pCurrentEnd);
-	m_Size = std::move(other.m_Size);
+	ReleaseStorage();
+
+	if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+		m_Alloc = std::move(other.m_Alloc);
 
-	other.m_pHead = nullptr;
-	other.m_pTail = nullptr;
-	other.m_pCurrentEnd = nullptr;
-	other.m_Size = 0;
+	StealFrom(other);
 
 	return *this;
 }
 
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::Swap(CustomString& other) noexcept
+{
+	if (this == &other)
+		return;
+
+	if constexpr (AllocTraits::propagate_on_container_swap::value)
+	{
+		using std::swap;
+		swap(m_Alloc, other.m_Alloc);
+	}
+	else
+	{
+		assert(m_Alloc == other.m_Alloc && "Swapping strings with unequal allocators is undefined");
+	}
+
+	/* Swap the storage bytes wholesale, the inline buffer shares them with the heap bookkeeping */
+	T buffer[SmallCapacity];
+	std::memcpy(buffer, m_Buffer, sizeof(m_Buffer));
+	std::memcpy(m_Buffer, other.m_Buffer, sizeof(m_Buffer));
+	std::memcpy(other.m_Buffer, buffer, sizeof(m_Buffer));
+
+	std::swap(m_Size, other.m_Size);
+	std::swap(m_HashCache, other.m_HashCache);
+}
+
 #pragma endregion
 
 #pragma region Adding_Chars
 
-template<typename T>
-CustomString<T>& CustomString<T>::Assign(const T c, const size_t count)
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>& CustomString<T, Alloc, GrowthPolicy, HashCache>::Assign(const T c, const size_t count)
 {
-	if (!m_pCurrentEnd || (m_pCurrentEnd + count) >= m_pTail)
+	if (count + 1 > Capacity())
 		Reallocate(count + 1);
 
-	if (m_pCurrentEnd > m_pHead)
-		--m_pCurrentEnd; /* If there is a null-terminator make sure we overwrite it */
-
+	T* pData{ MutableData() };
 	for (size_t i{}; i < count; ++i)
-		*m_pCurrentEnd++ = c;
+		pData[i] = c;
 
-	*m_pCurrentEnd++ = T();
-
-	m_Size += count;
+	SetSize(count);
+	m_HashCache.Reset();
 
 	return *this;
 }
 
-template<typename T>
-CustomString<T>& CustomString<T>::Assign(const T* pStr)
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>& CustomString<T, Alloc, GrowthPolicy, HashCache>::Assign(const T* pStr)
 {
 	assert(pStr != nullptr);
 
 	return Assign(pStr, CountRawString(pStr));
 }
 
-template<typename T>
-CustomString<T>& CustomString<T>::Assign(const T* pStr, size_t count)
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>& CustomString<T, Alloc, GrowthPolicy, HashCache>::Assign(const T* pStr, size_t count)
 {
-	if (pStr[count - 1] != '\0')
-		++count;
-
-	if (!m_pCurrentEnd || (m_pCurrentEnd + count) >= m_pTail)
-		Reallocate(count);
-
-	std::memcpy(m_pCurrentEnd, pStr, count);
+	/* count is allowed to include the null-terminator */
+	if (count > 0 && pStr[count - 1] == T())
+		--count;
 
-	m_pCurrentEnd = m_pCurrentEnd + count;
-	*(m_pCurrentEnd - 1) = T();
-
-	m_Size += count - 1;
+	AssignRaw(pStr, count);
 
 	return *this;
 }
 
-template<typename T>
-CustomString<T>& CustomString<T>::Append(const T c, const size_t count)
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>& CustomString<T, Alloc, GrowthPolicy, HashCache>::Append(const T c, const size_t count)
 {
-	if (!m_pCurrentEnd || (m_pCurrentEnd + count + 1) >= m_pTail)
-		Reallocate(m_Size + count + 1);
+	const size_t size{ Size() };
 
-	if (m_pCurrentEnd > m_pHead)
-		--m_pCurrentEnd;
+	if (size + count + 1 > Capacity())
+		Reallocate(size + count + 1);
 
+	T* pData{ MutableData() };
 	for (size_t i{}; i < count; ++i)
-		*m_pCurrentEnd++ = c;
+		pData[size + i] = c;
 
-	*m_pCurrentEnd++ = T();
-
-	m_Size += count;
+	SetSize(size + count);
 
 	return *this;
 }
 
-template<typename T>
-CustomString<T>& CustomString<T>::operator+=(const T* pStr)
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>& CustomString<T, Alloc, GrowthPolicy, HashCache>::operator+=(const T* pStr)
 {
-	const size_t size{ CountRawString(pStr) };
+	AppendRaw(pStr, CountRawString(pStr) - 1);
 
-	if (!m_pCurrentEnd || (m_pCurrentEnd + size) >= m_pTail)
-		Reallocate(m_Size + size);
+	return *this;
+}
 
-	if (m_pCurrentEnd > m_pHead)
-		--m_pCurrentEnd;
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>& CustomString<T, Alloc, GrowthPolicy, HashCache>::operator+=(const CustomString& other)
+{
+	AppendRaw(other.Data(), other.Size());
 
-	std::memcpy(m_pCurrentEnd, pStr, size);
+	return *this;
+}
 
-	m_pCurrentEnd += size;
+#pragma endregion
 
-	m_Size += size - 1;
+#pragma region Capacity
 
-	return *this;
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::Reserve(const size_t size)
+{
+	/* Makes room for size characters plus the null-terminator, without touching the new memory */
+	if (size + 1 > Capacity())
+	{
+		if (!std::as_const(*this).Data() && size < SmallCapacity)
+			Reallocate(size + 1);
+		else
+			ResizeBuffer(size + 1);
+	}
 }
 
-template<typename T>
-CustomString<T>& CustomString<T>::operator+=(const CustomString<T>& other)
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::ShrinkToFit()
 {
-	const size_t size{ other.Size() };
+	if (IsSmall() || !m_Heap.pHead)
+		return;
+
+	const size_t size{ Size() };
+
+	if (size < SmallCapacity)
+	{
+		/* The inline buffer overlaps the heap bookkeeping, so copy it out first */
+		HeapData heap{ m_Heap };
+
+		std::memcpy(m_Buffer, heap.pHead, size * sizeof(T));
+		m_Size = SmallFlag;
 
-	if (!m_pCurrentEnd || (m_pCurrentEnd + size + 1) >= m_pTail)
-		Reallocate(m_Size + size + 1);
+		DeleteData(heap.pHead, heap.pHead + heap.Capacity);
+		Release(heap.pHead, heap.Capacity);
 
-	if (m_pCurrentEnd > m_pHead)
-		--m_pCurrentEnd;
+		SetSize(size);
+	}
+	else if (size + 1 < Capacity())
+	{
+		ResizeBuffer(size + 1);
+	}
+}
 
-	std::memcpy(m_pCurrentEnd, other.Data(), size);
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::ResizeUninitialized(const size_t size)
+{
+	/* Characters past the old size are left uninitialized for the caller to overwrite */
+	Reserve(size);
+	SetSize(size);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Operation>
+CustomString<T, Alloc, GrowthPolicy, HashCache>& CustomString<T, Alloc, GrowthPolicy, HashCache>::ResizeAndOverwrite(const size_t size, Operation op)
+{
+	/* op(T* pData, size_t size) writes at most size characters and returns how many of them to keep */
+	Reserve(size);
 
-	m_pCurrentEnd += size;
-	*m_pCurrentEnd++ = T();
+	const size_t newSize{ static_cast<size_t>(op(MutableData(), size)) };
+	assert(newSize <= size);
 
-	m_Size += size;
+	SetSize(newSize);
 
 	return *this;
 }
@@ -346,91 +861,162 @@ CustomString<T>& CustomString<T>::operator+=(const CustomString<T>& other)
 
 #pragma region String_Information
 
-template<typename T>
-size_t CustomString<T>::Size() const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::Size() const
 {
-	return m_Size;
+	return m_Size & ~SmallFlag;
 }
 
-template<typename T>
-size_t CustomString<T>::Capacity() const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::Capacity() const
 {
-	return m_pTail - m_pHead;
+	return IsSmall() ? SmallCapacity : m_Heap.Capacity;
 }
 
-template<typename T>
-size_t CustomString<T>::MaxSize() const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::MaxSize() const
 {
-	return std::numeric_limits<size_t>::max();
+	/* The top bit of m_Size is SmallFlag, so neither the size nor the capacity the growth policies are capped at may reach it */
+	return SmallFlag - 1;
 }
 
-template<typename T>
-const T* CustomString<T>::Data() const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+T* CustomString<T, Alloc, GrowthPolicy, HashCache>::Data()
+{
+	/* The caller may write through the pointer at any later time */
+	m_HashCache.Leak();
+
+	return MutableData();
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+const T* CustomString<T, Alloc, GrowthPolicy, HashCache>::Data() const
+{
+	return IsSmall() ? m_Buffer : m_Heap.pHead;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+Alloc CustomString<T, Alloc, GrowthPolicy, HashCache>::GetAllocator() const
+{
+	return m_Alloc;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::Hash() const
+{
+	size_t hash{};
+	if (m_HashCache.TryGet(hash))
+		return hash;
+
+	hash = Hash(StringHash::DefaultSeed);
+	m_HashCache.Store(hash);
+
+	return hash;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::Hash(const uint64_t seed) const
 {
-	return m_pHead;
+	return static_cast<size_t>(StringHash::Hash(Data(), Size() * sizeof(T), seed));
 }
 
 #pragma endregion
 
 #pragma region Comparison
 
-template<typename T>
-bool CustomString<T>::operator==(const CustomString& other) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::operator==(const CustomString& other) const
 {
 	if (Size() != other.Size())
 		return false;
 
-	const T* pThisStr{ m_pHead };
-	const T* pOtherStr{ other.Data() };
+	/* Cached hashes can only reject, equal hashes still need the full comparison */
+	size_t hash{}, otherHash{};
+	if (m_HashCache.TryGet(hash) && other.m_HashCache.TryGet(otherHash) && hash != otherHash)
+		return false;
 
-	if (!pThisStr && !pOtherStr)
-		return true;
+	/* The characters are compared as raw bytes, so embedded nulls compare like any other character */
+	return StringSearch::Equals(Data(), other.Data(), Size() * sizeof(T));
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::operator==(const T* pStr) const
+{
+	/* pStr is not measured up front: it has to match every character and end exactly where we do.
+	   Its terminator stops the loop, so nothing past it is ever read */
+	assert(pStr != nullptr);
 
-	while ((*pThisStr != T()) && (*pOtherStr != T()))
+	const T* pData{ Data() };
+	const size_t size{ Size() };
+
+	for (size_t i{}; i < size; ++i)
 	{
-		if (*pThisStr != *pOtherStr)
+		if (pStr[i] != pData[i] || pStr[i] == T())
 			return false;
-
-		++pThisStr;
-		++pOtherStr;
 	}
 
-	if (*pThisStr != *pOtherStr)
-		return false;
-
-	return true;
+	return pStr[size] == T();
 }
 
-template<typename T>
-bool CustomString<T>::operator==(const T* pStr) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+std::strong_ordering CustomString<T, Alloc, GrowthPolicy, HashCache>::operator<=>(const CustomString& other) const
 {
-	if (Size() + 1 != CountRawString(pStr))
-		return false;
+	const size_t size{ std::min(Size(), other.Size()) };
+
+	/* The first differing byte lies in the first differing character */
+	const size_t index{ StringSearch::FindMismatch(Data(), other.Data(), size * sizeof(T)) / sizeof(T) };
+
+	if (index < size)
+		return CompareCodeUnits(Data()[index], other.Data()[index]);
+
+	return Size() <=> other.Size();
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+std::strong_ordering CustomString<T, Alloc, GrowthPolicy, HashCache>::operator<=>(const T* pStr) const
+{
+	assert(pStr != nullptr);
 
-	const T* pThisStr{ m_pHead };
-	while ((*pThisStr != T()) && (*pStr != T()))
+	const T* pData{ Data() };
+	const size_t size{ Size() };
+
+	for (size_t i{}; i < size; ++i)
 	{
-		if (*pThisStr != *pStr)
-			return false;
+		/* pStr ended first, so it is a prefix of this string */
+		if (pStr[i] == T())
+			return std::strong_ordering::greater;
 
-		++pThisStr;
-		++pStr;
+		if (pStr[i] != pData[i])
+			return CompareCodeUnits(pData[i], pStr[i]);
 	}
 
-	if (*pThisStr != *pStr)
-		return false;
+	return pStr[size] == T() ? std::strong_ordering::equal : std::strong_ordering::less;
+}
 
-	return true;
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Fold>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::EqualsIgnoreCase(const CustomString& other) const
+{
+	return Size() == other.Size() && EqualsIgnoreCaseRaw<Fold>(Data(), other.Data(), Size());
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Fold>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::EqualsIgnoreCase(const T* pStr) const
+{
+	const size_t size{ CountRawString(pStr) - 1 };
+
+	return Size() == size && EqualsIgnoreCaseRaw<Fold>(Data(), pStr, size);
 }
 
 #pragma endregion
 
 #pragma region String_Manipulation
 
-template<typename T>
-CustomString<T>& CustomString<T>::ToUpper()
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>& CustomString<T, Alloc, GrowthPolicy, HashCache>::ToUpper()
 {
-	T* pStr{ m_pHead };
+	T* pStr{ MutableData() };
 
 	while (pStr != nullptr && *pStr != T())
 	{
@@ -443,10 +1029,10 @@ CustomString<T>& CustomString<T>::ToUpper()
 	return *this;
 }
 
-template<typename T>
-CustomString<T>& CustomString<T>::ToLower()
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache>& CustomString<T, Alloc, GrowthPolicy, HashCache>::ToLower()
 {
-	T* pStr{ m_pHead };
+	T* pStr{ MutableData() };
 
 	while (pStr != nullptr && *pStr != T())
 	{
@@ -463,280 +1049,438 @@ CustomString<T>& CustomString<T>::ToLower()
 
 #pragma region Element_Access
 
-template<typename T>
-T& CustomString<T>::operator[](const size_t index)
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+T& CustomString<T, Alloc, GrowthPolicy, HashCache>::operator[](const size_t index)
 {
 	assert(index < Size());
 
-	return *(m_pHead + index);
+	return *(Data() + index);
 }
 
-template<typename T>
-const T& CustomString<T>::operator[](const size_t index) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+const T& CustomString<T, Alloc, GrowthPolicy, HashCache>::operator[](const size_t index) const
 {
 	assert(index < Size());
 
-	return *(m_pHead + index);
+	return *(Data() + index);
 }
 
 #pragma endregion
 
 #pragma region Utility
 
-template<typename T>
-CustomString<T> CustomString<T>::Substring(const size_t start, const size_t count) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+CustomString<T, Alloc, GrowthPolicy, HashCache> CustomString<T, Alloc, GrowthPolicy, HashCache>::Substring(const size_t start, const size_t count) const
 {
-	assert(start < m_Size);
-
-	CustomString<T> string{};
-	size_t substrCounter{};
-
-	while ((substrCounter < count) &&
-		(start + substrCounter < m_Size) &&
-		(*(m_pHead + start + substrCounter) != T()))
-	{
-		++substrCounter;
-	}
+	assert(start < Size());
 
-	string.Assign(m_pHead + start, substrCounter);
+	CustomString string{ AllocTraits::select_on_container_copy_construction(m_Alloc) };
+	string.AssignRaw(Data() + start, std::min(count, Size() - start));
 
 	return string;
 }
 
-template<typename T>
-bool CustomString<T>::StartsWith(const CustomString<T>& str) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::StartsWith(const CustomString& str) const
 {
-	if (!m_pHead)
+	/* An empty needle matches every string, even one without a buffer */
+	if (str.Size() == 0)
+		return true;
+
+	const T* pData{ Data() };
+	if (!pData)
 		return false;
 
 	for (size_t i{}; i < str.Size(); ++i)
 	{
-		if (*(m_pHead + i) == T() || str[i] == T())
+		if (*(pData + i) == T() || str[i] == T())
 			return false;
 
-		if (*(m_pHead + i) != str[i])
+		if (*(pData + i) != str[i])
 			return false;
 	}
 
 	return true;
 }
 
-template<typename T>
-bool CustomString<T>::StartsWith(const T* pStr) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::StartsWith(const T* pStr) const
 {
-	if (!m_pHead)
+	const size_t size{ CountRawString(pStr) - 1 };
+	if (size == 0)
+		return true;
+
+	const T* pData{ Data() };
+	if (!pData)
 		return false;
 
-	const size_t size{ CountRawString(pStr) - 1 };
 	for (size_t i{}; i < size; ++i)
 	{
-		if (*(m_pHead + i) == T() || *(pStr + i) == T())
+		if (*(pData + i) == T() || *(pStr + i) == T())
 			return false;
 
-		if (*(m_pHead + i) != *(pStr + i))
+		if (*(pData + i) != *(pStr + i))
 			return false;
 	}
 
 	return true;
 }
 
-template<typename T>
-bool CustomString<T>::EndsWith(const CustomString<T>& str) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::EndsWith(const CustomString& str) const
 {
-	if (!m_pHead || str.Size() > m_Size)
+	if (str.Size() == 0)
+		return true;
+
+	const T* pData{ Data() };
+	if (!pData || str.Size() > Size())
 		return false;
 
-	const size_t offset{ m_Size - str.Size() };
+	const size_t offset{ Size() - str.Size() };
 	for (size_t i{}; i < str.Size(); ++i)
 	{
-		if (*(m_pHead + i + offset) == T() || str[i] == T())
+		if (*(pData + i + offset) == T() || str[i] == T())
 			return false;
 
-		if (*(m_pHead + i + offset) != str[i])
+		if (*(pData + i + offset) != str[i])
 			return false;
 	}
 
 	return true;
 }
 
-template<typename T>
-bool CustomString<T>::EndsWith(const T* pStr) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::EndsWith(const T* pStr) const
 {
 	const size_t size{ CountRawString(pStr) - 1 };
+	if (size == 0)
+		return true;
 
-	if (!m_pHead || size > m_Size)
+	const T* pData{ Data() };
+	if (!pData || size > Size())
 		return false;
 
-	const size_t offset{ m_Size - size };
+	const size_t offset{ Size() - size };
 	for (size_t i{}; i < size; ++i)
 	{
-		if (*(m_pHead + i + offset) == T() || pStr[i] == T())
+		if (*(pData + i + offset) == T() || pStr[i] == T())
 			return false;
 
-		if (*(m_pHead + i + offset) != pStr[i])
+		if (*(pData + i + offset) != pStr[i])
 			return false;
 	}
 
 	return true;
 }
 
-template<typename T>
-size_t CustomString<T>::IndexOf(const T c) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOf(const T c) const
 {
-	for (size_t i{}; i < m_Size; ++i)
+	const T* pData{ Data() };
+	const size_t dataSize{ Size() };
+
+	if constexpr (sizeof(T) == 1)
 	{
-		if (*(m_pHead + i) == c)
-			return i;
+		const void* pMatch{ StringSearch::FindByte(pData, dataSize, static_cast<unsigned char>(c)) };
+
+		return pMatch ? static_cast<size_t>(static_cast<const T*>(pMatch) - pData) : NoPos;
 	}
+	else
+	{
+		for (size_t i{}; i < dataSize; ++i)
+		{
+			if (*(pData + i) == c)
+				return i;
+		}
 
-	return NoPos;
+		return NoPos;
+	}
 }
 
-template<typename T>
-size_t CustomString<T>::IndexOf(const CustomString<T>& str) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOf(const CustomString& str) const
 {
-	const size_t size{ str.Size() };
-	if (size > m_Size)
-		return NoPos;
+	return IndexOfRaw(str.Data(), str.Size());
+}
 
-	for (size_t i{}; i < m_Size; ++i)
-	{
-		bool containsString{ true };
-		for (size_t j{}; j < size; ++j)
-		{
-			if (m_pHead[i + j] != str[j])
-			{
-				containsString = false;
-				break;
-			}
-		}
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOf(const T* pStr) const
+{
+	return IndexOfRaw(pStr, CountRawString(pStr) - 1);
+}
 
-		if (containsString)
-			return i;
-	}
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOf(const Searcher<T>& searcher) const
+{
+	/* Searcher lives in Searcher.h, include it wherever this overload is used */
+	return searcher.FindIn(Data(), Size());
+}
 
-	return NoPos;
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+ApproxMatch CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOfApprox(const CustomString& str, const size_t maxDistance) const
+{
+	/* ApproxSearcher lives in ApproxSearcher.h, include it wherever IndexOfApprox() is used */
+	return ApproxSearcher<T>{ str.Data(), str.Size() }.FindIn(Data(), Size(), maxDistance);
 }
 
-template<typename T>
-size_t CustomString<T>::IndexOf(const T* pStr) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+ApproxMatch CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOfApprox(const T* pStr, const size_t maxDistance) const
 {
-	const size_t size{ CountRawString(pStr) - 1 };
-	if (size > m_Size)
-		return NoPos;
+	return ApproxSearcher<T>{ pStr, CountRawString(pStr) - 1 }.FindIn(Data(), Size(), maxDistance);
+}
 
-	for (size_t i{}; i < m_Size; ++i)
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+ApproxMatch CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOfApprox(const ApproxSearcher<T>& searcher, const size_t maxDistance) const
+{
+	return searcher.FindIn(Data(), Size(), maxDistance);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::LastIndexOf(const T c) const
+{
+	const T* pData{ Data() };
+	const size_t dataSize{ Size() };
+
+	if constexpr (sizeof(T) == 1)
+	{
+		const void* pMatch{ StringSearch::FindLastByte(pData, dataSize, static_cast<unsigned char>(c)) };
+
+		return pMatch ? static_cast<size_t>(static_cast<const T*>(pMatch) - pData) : NoPos;
+	}
+	else
 	{
-		bool containsString{ true };
-		for (size_t j{}; j < size; ++j)
+		for (size_t i{ dataSize }; i > 0; --i)
 		{
-			if (m_pHead[i + j] != pStr[j])
-			{
-				containsString = false;
-				break;
-			}
+			if (pData[i - 1] == c)
+				return i - 1;
 		}
 
-		if (containsString)
-			return i;
+		return NoPos;
 	}
+}
 
-	return NoPos;
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::LastIndexOf(const CustomString& str) const
+{
+	return LastIndexOfRaw(str.Data(), str.Size());
 }
 
-template<typename T>
-bool CustomString<T>::Contains(const T c) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::LastIndexOf(const T* pStr) const
 {
-	for (size_t i{}; i < m_Size; ++i)
-	{
-		if (m_pHead[i] == c)
-			return true;
-	}
+	return LastIndexOfRaw(pStr, CountRawString(pStr) - 1);
+}
 
-	return false;
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOfAny(const CharSet& set) const
+{
+	return IndexOfInSet(set, true);
 }
 
-template<typename T>
-bool CustomString<T>::Contains(const CustomString<T>& str) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOfNotAny(const CharSet& set) const
+{
+	return IndexOfInSet(set, false);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::Span(const CharSet& set) const
+{
+	/* Length of the prefix made up of characters in the set, like strspn() */
+	const size_t index{ IndexOfNotAny(set) };
+
+	return index == NoPos ? Size() : index;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::ComplementSpan(const CharSet& set) const
+{
+	/* Length of the prefix made up of characters not in the set, like strcspn() */
+	const size_t index{ IndexOfAny(set) };
+
+	return index == NoPos ? Size() : index;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::Contains(const T c) const
+{
+	return IndexOf(c) != NoPos;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::Contains(const CustomString& str) const
 {
 	return IndexOf(str) != NoPos;
 }
 
-template<typename T>
-bool CustomString<T>::Contains(const T* pStr) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::Contains(const T* pStr) const
 {
 	return IndexOf(pStr) != NoPos;
 }
 
-#pragma endregion
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::Count(const CustomString& str, const bool overlapping) const
+{
+	size_t count{};
 
-#pragma region Reallocation
+	for ([[maybe_unused]] const size_t position : FindAll(str, overlapping))
+		++count;
 
-template<typename T>
-void CustomString<T>::Reallocate(const size_t min)
+	return count;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::Count(const T* pStr, const bool overlapping) const
 {
-	const uint64_t oldSize{ Size() };
-	const uint64_t newCap{ CalculateNewCapacity(min) };
+	size_t count{};
 
-	T* pNewHead{ new T[newCap]{} };
+	for ([[maybe_unused]] const size_t position : FindAll(pStr, overlapping))
+		++count;
 
-	T* pOldHead{ m_pHead };
-	T* pOldTail{ m_pTail };
+	return count;
+}
 
-	m_pHead = pNewHead;
-	m_pTail = pNewHead + newCap;
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+typename CustomString<T, Alloc, GrowthPolicy, HashCache>::FindRange CustomString<T, Alloc, GrowthPolicy, HashCache>::FindAll(const CustomString& str, const bool overlapping) const
+{
+	return FindRange{ this, str.Data(), str.Size(), overlapping };
+}
 
-	std::memcpy(m_pHead, pOldHead, oldSize);
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+typename CustomString<T, Alloc, GrowthPolicy, HashCache>::FindRange CustomString<T, Alloc, GrowthPolicy, HashCache>::FindAll(const T* pStr, const bool overlapping) const
+{
+	return FindRange{ this, pStr, CountRawString(pStr) - 1, overlapping };
+}
 
-	m_pCurrentEnd = m_pHead + oldSize;
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Fold>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::StartsWithIgnoreCase(const CustomString& str) const
+{
+	return StartsWithIgnoreCaseRaw<Fold>(str.Data(), str.Size());
+}
 
-	if (m_pCurrentEnd > m_pHead)
-		*m_pCurrentEnd++ = T();
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Fold>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::StartsWithIgnoreCase(const T* pStr) const
+{
+	return StartsWithIgnoreCaseRaw<Fold>(pStr, CountRawString(pStr) - 1);
+}
 
-	DeleteData(pOldHead, pOldTail);
-	Release(pOldHead);
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Fold>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::EndsWithIgnoreCase(const CustomString& str) const
+{
+	return EndsWithIgnoreCaseRaw<Fold>(str.Data(), str.Size());
 }
 
-template<typename T>
-constexpr size_t CustomString<T>::CalculateNewCapacity(const size_t min) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Fold>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::EndsWithIgnoreCase(const T* pStr) const
 {
-	const size_t oldCap{ Capacity() };
-	const size_t maxCap{ MaxSize() };
+	return EndsWithIgnoreCaseRaw<Fold>(pStr, CountRawString(pStr) - 1);
+}
 
-	if (oldCap > maxCap - oldCap / 2u)
-	{
-		return maxCap;
-	}
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Fold>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOfIgnoreCase(const CustomString& str) const
+{
+	return IndexOfIgnoreCaseRaw<Fold>(str.Data(), str.Size());
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Fold>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOfIgnoreCase(const T* pStr) const
+{
+	return IndexOfIgnoreCaseRaw<Fold>(pStr, CountRawString(pStr) - 1);
+}
+
+#pragma endregion
 
-	const size_t newCap{ oldCap + oldCap / 2u };
+#pragma region Reallocation
 
-	// If our growth is insufficient, return just the bare minimum
-	if (newCap < min)
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::Reallocate(const size_t min)
+{
+	/* An empty string only needs its inline buffer as long as the contents fit */
+	if (!std::as_const(*this).Data() && min <= SmallCapacity)
 	{
-		return min;
+		m_Size = SmallFlag;
+		m_Buffer[0] = T();
+		return;
 	}
 
+	ResizeBuffer(CalculateNewCapacity(min));
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::ResizeBuffer(const size_t newCap)
+{
+	const size_t oldSize{ Size() };
+
+	assert(newCap > oldSize);
+	assert(newCap <= MaxSize() && "The string can not grow this large");
+
+	/* The new buffer is left uninitialized, only our contents get copied over */
+	T* pNewHead{ Allocate(newCap) };
+
+	if (const T* pOldHead{ std::as_const(*this).Data() }; pOldHead)
+		std::memcpy(pNewHead, pOldHead, oldSize * sizeof(T));
+
+	pNewHead[oldSize] = T();
+
+	ReleaseStorage();
+
+	m_Heap.pHead = pNewHead;
+	m_Heap.Capacity = newCap;
+	m_Size = oldSize;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+constexpr size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::CalculateNewCapacity(const size_t min) const
+{
+	assert(min <= MaxSize() && "The string can not grow this large");
+
+	const size_t newCap{ GrowthPolicy::template CalculateNewCapacity<T>(Capacity(), min, MaxSize()) };
+	assert(newCap >= min && newCap <= MaxSize());
+
 	return newCap;
 }
 
-template<typename T>
-constexpr void CustomString<T>::Release(T*& pData)
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+T* CustomString<T, Alloc, GrowthPolicy, HashCache>::Allocate(const size_t cap)
+{
+	return AllocTraits::allocate(m_Alloc, cap);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+constexpr void CustomString<T, Alloc, GrowthPolicy, HashCache>::Release(T*& pData, const size_t cap)
 {
 	if (pData)
 	{
-		delete[] pData;
+		AllocTraits::deallocate(m_Alloc, pData, cap);
 		pData = nullptr;
 	}
 }
 
-template<typename T>
-constexpr void CustomString<T>::DeleteData(T* head, T* const tail) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::ReleaseStorage()
+{
+	if (!IsSmall() && m_Heap.pHead)
+	{
+		DeleteData(m_Heap.pHead, m_Heap.pHead + m_Heap.Capacity);
+		Release(m_Heap.pHead, m_Heap.Capacity);
+	}
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+constexpr void CustomString<T, Alloc, GrowthPolicy, HashCache>::DeleteData(T* head, T* const tail)
 {
 	if constexpr (!std::is_trivially_destructible_v<T>)
 	{
 		while (head < tail)
 		{
-			head->~T();
+			AllocTraits::destroy(m_Alloc, head);
 			++head;
 		}
 	}
@@ -744,10 +1488,128 @@ constexpr void CustomString<T>::DeleteData(T* head, T* const tail) const
 
 #pragma endregion
 
+#pragma region Small_String
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::IsSmall() const
+{
+	return (m_Size & SmallFlag) != 0;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+T* CustomString<T, Alloc, GrowthPolicy, HashCache>::MutableData()
+{
+	m_HashCache.Invalidate();
+
+	return IsSmall() ? m_Buffer : m_Heap.pHead;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::SetSize(const size_t size)
+{
+	m_Size = size | (m_Size & SmallFlag);
+	MutableData()[size] = T();
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::SetEmpty()
+{
+	/* Forgets the storage without releasing it */
+	m_Heap = HeapData{};
+	m_Size = 0;
+	m_HashCache.Reset();
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::AssignRaw(const T* pStr, const size_t count)
+{
+	if (count + 1 > Capacity())
+	{
+		/* Our old contents get replaced, so there is nothing worth preserving */
+		m_Size &= SmallFlag;
+		Reallocate(count + 1);
+	}
+
+	std::memmove(MutableData(), pStr, count * sizeof(T));
+
+	SetSize(count);
+	m_HashCache.Reset();
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::AppendRaw(const T* pStr, const size_t count)
+{
+	const size_t size{ Size() };
+
+	if (size + count + 1 > Capacity())
+	{
+		/* pStr might point into our own buffer, which does not survive the reallocation */
+		const T* pData{ std::as_const(*this).Data() };
+		const bool isAliased{ pData && !std::less<const T*>{}(pStr, pData) && std::less<const T*>{}(pStr, pData + size + 1) };
+		const size_t offset{ isAliased ? static_cast<size_t>(pStr - pData) : 0u };
+
+		Reallocate(size + count + 1);
+
+		if (isAliased)
+			pStr = std::as_const(*this).Data() + offset;
+	}
+
+	std::memmove(MutableData() + size, pStr, count * sizeof(T));
+
+	SetSize(size + count);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::CopyFrom(const CustomString& other)
+{
+	/* Expects our own storage to be released already */
+	SetEmpty();
+
+	/* The copy gets a buffer of its own, so only a valid hash carries over and not the other's leaked state */
+	size_t hash{};
+	if (other.m_HashCache.TryGet(hash))
+		m_HashCache.Store(hash);
+
+	const T* pOtherData{ other.Data() };
+	if (!pOtherData)
+		return;
+
+	const size_t size{ other.Size() };
+
+	if (size < SmallCapacity)
+	{
+		std::memcpy(m_Buffer, pOtherData, (size + 1) * sizeof(T));
+		m_Size = size | SmallFlag;
+		return;
+	}
+
+	const size_t cap{ other.Capacity() };
+
+	m_Heap.pHead = Allocate(cap);
+	m_Heap.Capacity = cap;
+
+	std::memcpy(m_Heap.pHead, pOtherData, (size + 1) * sizeof(T));
+
+	m_Size = size;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+void CustomString<T, Alloc, GrowthPolicy, HashCache>::StealFrom(CustomString& other)
+{
+	/* Expects our own storage to be released already, the storage bytes are the same for both modes */
+	std::memcpy(m_Buffer, other.m_Buffer, sizeof(m_Buffer));
+	m_Size = other.m_Size;
+	m_HashCache = other.m_HashCache;
+
+	other.SetEmpty();
+}
+
+#pragma endregion
+
 #pragma region Helpers
 
-template<typename T>
-size_t CustomString<T>::CountRawString(const T* pStr) const
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::CountRawString(const T* pStr) const
 {
 	// Count length of null-terminated string
 	assert(pStr != nullptr);
@@ -762,4 +1624,144 @@ size_t CustomString<T>::CountRawString(const T* pStr) const
 	return ++counter;
 }
 
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+constexpr std::strong_ordering CustomString<T, Alloc, GrowthPolicy, HashCache>::CompareCodeUnits(const T a, const T b)
+{
+	/* Code units are unsigned, so e.g. char 0xE9 orders after 'z' just like it does with memcmp() */
+	if constexpr (std::is_integral_v<T>)
+		return static_cast<std::make_unsigned_t<T>>(a) <=> static_cast<std::make_unsigned_t<T>>(b);
+	else
+		return a <=> b;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOfRaw(const T* pStr, const size_t count, const size_t start) const
+{
+	assert(start <= Size());
+
+	/* An empty needle matches right at the start, also in a string without a buffer */
+	if (count == 0)
+		return start;
+
+	const T* pData{ Data() };
+	const T* pHaystack{ pData + start };
+	const size_t haystackSize{ Size() - start };
+	const T* pMatch{};
+
+	/* Long haystacks go through the SIMD filter, short ones are not worth the call */
+	if constexpr (sizeof(T) == 1)
+	{
+		if (count == 1)
+			pMatch = static_cast<const T*>(StringSearch::FindByte(pHaystack, haystackSize, static_cast<unsigned char>(*pStr)));
+		else if (haystackSize >= StringSearch::MinVectorSubstringSize)
+			pMatch = static_cast<const T*>(StringSearch::FindBytes(pHaystack, haystackSize, pStr, count));
+		else
+			pMatch = StringSearch::FindSubstring(pHaystack, haystackSize, pStr, count);
+	}
+	else
+	{
+		pMatch = StringSearch::FindSubstring(pHaystack, haystackSize, pStr, count);
+	}
+
+	return pMatch ? static_cast<size_t>(pMatch - pData) : NoPos;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::LastIndexOfRaw(const T* pStr, const size_t count) const
+{
+	if (count == 0)
+		return Size();
+	if (count == 1)
+		return LastIndexOf(*pStr);
+
+	const T* pData{ Data() };
+	const T* pMatch{};
+
+	if constexpr (sizeof(T) == 1)
+	{
+		if (Size() >= StringSearch::MinVectorSubstringSize)
+			pMatch = static_cast<const T*>(StringSearch::FindLastBytes(pData, Size(), pStr, count));
+		else
+			pMatch = StringSearch::FindLastSubstring(pData, Size(), pStr, count);
+	}
+	else
+	{
+		pMatch = StringSearch::FindLastSubstring(pData, Size(), pStr, count);
+	}
+
+	return pMatch ? static_cast<size_t>(pMatch - pData) : NoPos;
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOfInSet(const CharSet& set, const bool inSet) const
+{
+	const T* pData{ Data() };
+	const size_t dataSize{ Size() };
+
+	if constexpr (sizeof(T) == 1)
+	{
+		const void* pMatch{ inSet ? StringSearch::FindAnyOf(pData, dataSize, set) : StringSearch::FindNoneOf(pData, dataSize, set) };
+
+		return pMatch ? static_cast<size_t>(static_cast<const T*>(pMatch) - pData) : NoPos;
+	}
+	else
+	{
+		/* Characters beyond the range of a CharSet are never in it */
+		using UnsignedT = std::make_unsigned_t<T>;
+
+		for (size_t i{}; i < dataSize; ++i)
+		{
+			const UnsignedT c{ static_cast<UnsignedT>(pData[i]) };
+
+			if ((c < 256u && set.Contains(static_cast<unsigned char>(c))) == inSet)
+				return i;
+		}
+
+		return NoPos;
+	}
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Fold>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::EqualsIgnoreCaseRaw(const T* pA, const T* pB, const size_t count)
+{
+	/* Only the ASCII fold has SIMD kernels, any other fold is compared one character at a time */
+	if constexpr (sizeof(T) == 1 && std::is_same_v<Fold, StringSearch::AsciiCaseFold>)
+		return StringSearch::EqualsIgnoreCase(pA, pB, count);
+	else
+		return StringSearch::EqualsFolded<Fold>(pA, pB, count);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Fold>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::StartsWithIgnoreCaseRaw(const T* pStr, const size_t count) const
+{
+	return count <= Size() && EqualsIgnoreCaseRaw<Fold>(Data(), pStr, count);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Fold>
+bool CustomString<T, Alloc, GrowthPolicy, HashCache>::EndsWithIgnoreCaseRaw(const T* pStr, const size_t count) const
+{
+	return count <= Size() && EqualsIgnoreCaseRaw<Fold>(Data() + (Size() - count), pStr, count);
+}
+
+template<typename T, typename Alloc, typename GrowthPolicy, typename HashCache>
+template<typename Fold>
+size_t CustomString<T, Alloc, GrowthPolicy, HashCache>::IndexOfIgnoreCaseRaw(const T* pStr, const size_t count) const
+{
+	if (count == 0)
+		return 0;
+
+	const T* pData{ Data() };
+	const T* pMatch{};
+
+	if constexpr (sizeof(T) == 1 && std::is_same_v<Fold, StringSearch::AsciiCaseFold>)
+		pMatch = static_cast<const T*>(StringSearch::FindBytesIgnoreCase(pData, Size(), pStr, count));
+	else
+		pMatch = StringSearch::FindSubstringFolded<Fold>(pData, Size(), pStr, count);
+
+	return pMatch ? static_cast<size_t>(pMatch - pData) : NoPos;
+}
+
 #pragma endregion
\ No newline at end of file
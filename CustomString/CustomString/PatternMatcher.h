@@ -0,0 +1,514 @@
+#pragma once
+
+#include "CustomString.h"
+
+#include <vector> /* std::vector */
+#include <array> /* std::array */
+#include <cstdint> /* uint32_t */
+#include <iterator> /* std::default_sentinel_t, std::forward_iterator_tag */
+
+/* Aho-Corasick automaton over a fixed set of patterns. Every query makes a single pass over the haystack,
+   no matter how many patterns there are.
+   Transitions are stored as one flat table of rows, one column per character class. Characters that appear in
+   no pattern share a single class, so the rows stay as narrow as the patterns' alphabet. */
+template<typename T>
+class PatternMatcher final
+{
+public:
+	constexpr static size_t NoPos{ std::numeric_limits<size_t>::max() };
+
+	struct Match final
+	{
+		size_t Position; // NoPos if nothing matched
+		size_t Size;
+		size_t PatternIndex; // Index into the patterns the matcher was built from
+	};
+
+	/* Yields every occurrence of every pattern, overlapping ones included, ordered by where they end.
+	   Matches ending at the same position are ordered from longest to shortest */
+	class MatchIterator final
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Match;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = Match;
+
+		MatchIterator() = default;
+		MatchIterator(const PatternMatcher* pMatcher, const T* pHaystack, const size_t haystackSize);
+
+		NODISCARD Match operator*() const;
+		MatchIterator& operator++();
+		MatchIterator operator++(int);
+
+		NODISCARD bool operator==(const MatchIterator& other) const;
+		NODISCARD bool operator==(std::default_sentinel_t) const;
+
+	private:
+		void Advance();
+
+		const PatternMatcher* m_pMatcher{};
+		const T* m_pHaystack{};
+		size_t m_HaystackSize{};
+		size_t m_Position{}; // One past the last character fed to the automaton
+		uint32_t m_State{};
+		uint32_t m_OutputState{}; // State whose pattern is the current match, 0 once exhausted
+	};
+
+	class MatchRange final
+	{
+	public:
+		MatchRange(const PatternMatcher* pMatcher, const T* pHaystack, const size_t haystackSize);
+
+		NODISCARD MatchIterator begin() const;
+		NODISCARD std::default_sentinel_t end() const;
+
+	private:
+		const PatternMatcher* m_pMatcher;
+		const T* m_pHaystack;
+		size_t m_HaystackSize;
+	};
+
+#pragma region Ctors_Dtors
+
+	/* Elements can be anything with Data() and Size(), e.g. CustomString<T>. Empty patterns never match */
+	template<typename ForwardIt>
+	PatternMatcher(ForwardIt first, ForwardIt last);
+	explicit PatternMatcher(const std::vector<CustomString<T>>& patterns);
+
+#pragma endregion
+
+#pragma region Matching
+
+	template<typename ... Ts>
+	NODISCARD bool ContainsAny(const CustomString<T, Ts...>& haystack) const;
+	NODISCARD bool ContainsAny(const T* pHaystack, const size_t haystackSize) const;
+
+	/* The match that ends first, the longest one if several end at the same position */
+	template<typename ... Ts>
+	NODISCARD Match FirstMatch(const CustomString<T, Ts...>& haystack) const;
+	NODISCARD Match FirstMatch(const T* pHaystack, const size_t haystackSize) const;
+
+	template<typename ... Ts>
+	NODISCARD MatchRange Matches(const CustomString<T, Ts...>& haystack) const;
+	NODISCARD MatchRange Matches(const T* pHaystack, const size_t haystackSize) const;
+
+#pragma endregion
+
+#pragma region Matcher_Information
+
+	NODISCARD size_t NrOfPatterns() const;
+	NODISCARD size_t NrOfStates() const;
+	NODISCARD size_t NrOfCharacterClasses() const;
+	NODISCARD size_t MemoryUsage() const;
+
+#pragma endregion
+
+private:
+	constexpr static uint32_t NoPattern{ std::numeric_limits<uint32_t>::max() };
+	constexpr static uint32_t RootState{ 0 };
+
+	struct StateInfo final
+	{
+		uint32_t Pattern; // Pattern ending in this state, NoPattern if none
+		uint32_t OutputLink; // Nearest state along the failure links that has a pattern, RootState if none
+	};
+
+#pragma region Helpers
+
+	void BuildAlphabet(const T* pPattern, const size_t size);
+	void AddPattern(const T* pPattern, const size_t size, const uint32_t patternIndex);
+	void BuildFailureLinks();
+	uint32_t AddState();
+	NODISCARD uint32_t GetClass(const T c) const;
+	NODISCARD uint32_t Step(const uint32_t state, const T c) const;
+	NODISCARD uint32_t GetFirstOutput(const uint32_t state) const;
+	NODISCARD Match MakeMatch(const uint32_t outputState, const size_t end) const;
+
+#pragma endregion
+
+	std::vector<uint32_t> m_Transitions; // NrOfStates() rows of NrOfCharacterClasses() columns
+	std::vector<StateInfo> m_States;
+	std::vector<size_t> m_PatternSizes;
+	size_t m_NrOfClasses;
+
+	/* Class 0 is every character that appears in no pattern. Single-byte characters use a lookup table,
+	   wider characters a sorted list of the characters that do appear */
+	std::array<uint32_t, 256> m_ByteClasses;
+	std::vector<T> m_Alphabet;
+};
+
+#pragma region MatchIterator
+
+template<typename T>
+PatternMatcher<T>::MatchIterator::MatchIterator(const PatternMatcher* pMatcher, const T* pHaystack, const size_t haystackSize)
+	: m_pMatcher{ pMatcher }
+	, m_pHaystack{ pHaystack }
+	, m_HaystackSize{ haystackSize }
+	, m_Position{}
+	, m_State{ RootState }
+	, m_OutputState{ RootState }
+{
+	Advance();
+}
+
+template<typename T>
+typename PatternMatcher<T>::Match PatternMatcher<T>::MatchIterator::operator*() const
+{
+	assert(m_OutputState != RootState);
+
+	return m_pMatcher->MakeMatch(m_OutputState, m_Position);
+}
+
+template<typename T>
+typename PatternMatcher<T>::MatchIterator& PatternMatcher<T>::MatchIterator::operator++()
+{
+	Advance();
+
+	return *this;
+}
+
+template<typename T>
+typename PatternMatcher<T>::MatchIterator PatternMatcher<T>::MatchIterator::operator++(int)
+{
+	MatchIterator copy{ *this };
+	Advance();
+
+	return copy;
+}
+
+template<typename T>
+bool PatternMatcher<T>::MatchIterator::operator==(const MatchIterator& other) const
+{
+	if (m_OutputState == RootState || other.m_OutputState == RootState)
+		return m_OutputState == other.m_OutputState;
+
+	return m_pHaystack == other.m_pHaystack && m_Position == other.m_Position && m_OutputState == other.m_OutputState;
+}
+
+template<typename T>
+bool PatternMatcher<T>::MatchIterator::operator==(std::default_sentinel_t) const
+{
+	return m_OutputState == RootState;
+}
+
+template<typename T>
+void PatternMatcher<T>::MatchIterator::Advance()
+{
+	/* First walk the remaining, shorter patterns that end at the same position */
+	if (m_OutputState != RootState)
+	{
+		m_OutputState = m_pMatcher->m_States[m_OutputState].OutputLink;
+
+		if (m_OutputState != RootState)
+			return;
+	}
+
+	while (m_Position < m_HaystackSize)
+	{
+		m_State = m_pMatcher->Step(m_State, m_pHaystack[m_Position++]);
+		m_OutputState = m_pMatcher->GetFirstOutput(m_State);
+
+		if (m_OutputState != RootState)
+			return;
+	}
+}
+
+#pragma endregion
+
+#pragma region MatchRange
+
+template<typename T>
+PatternMatcher<T>::MatchRange::MatchRange(const PatternMatcher* pMatcher, const T* pHaystack, const size_t haystackSize)
+	: m_pMatcher{ pMatcher }
+	, m_pHaystack{ pHaystack }
+	, m_HaystackSize{ haystackSize }
+{}
+
+template<typename T>
+typename PatternMatcher<T>::MatchIterator PatternMatcher<T>::MatchRange::begin() const
+{
+	return MatchIterator{ m_pMatcher, m_pHaystack, m_HaystackSize };
+}
+
+template<typename T>
+std::default_sentinel_t PatternMatcher<T>::MatchRange::end() const
+{
+	return std::default_sentinel;
+}
+
+#pragma endregion
+
+#pragma region Ctors_Dtors
+
+template<typename T>
+template<typename ForwardIt>
+PatternMatcher<T>::PatternMatcher(ForwardIt first, ForwardIt last)
+	: m_Transitions{}
+	, m_States{}
+	, m_PatternSizes{}
+	, m_NrOfClasses{ 1 }
+	, m_ByteClasses{}
+	, m_Alphabet{}
+{
+	/* The alphabet has to be known up front, it decides the width of every row */
+	for (ForwardIt it{ first }; it != last; ++it)
+		BuildAlphabet(it->Data(), it->Size());
+
+	if constexpr (sizeof(T) != 1)
+	{
+		std::sort(m_Alphabet.begin(), m_Alphabet.end());
+		m_Alphabet.erase(std::unique(m_Alphabet.begin(), m_Alphabet.end()), m_Alphabet.end());
+		m_NrOfClasses = m_Alphabet.size() + 1;
+	}
+
+	AddState();
+
+	uint32_t patternIndex{};
+	for (; first != last; ++first, ++patternIndex)
+		AddPattern(first->Data(), first->Size(), patternIndex);
+
+	BuildFailureLinks();
+}
+
+template<typename T>
+PatternMatcher<T>::PatternMatcher(const std::vector<CustomString<T>>& patterns)
+	: PatternMatcher{ patterns.begin(), patterns.end() }
+{}
+
+#pragma endregion
+
+#pragma region Matching
+
+template<typename T>
+template<typename ... Ts>
+bool PatternMatcher<T>::ContainsAny(const CustomString<T, Ts...>& haystack) const
+{
+	return ContainsAny(haystack.Data(), haystack.Size());
+}
+
+template<typename T>
+bool PatternMatcher<T>::ContainsAny(const T* pHaystack, const size_t haystackSize) const
+{
+	uint32_t state{ RootState };
+
+	for (size_t i{}; i < haystackSize; ++i)
+	{
+		state = Step(state, pHaystack[i]);
+
+		if (GetFirstOutput(state) != RootState)
+			return true;
+	}
+
+	return false;
+}
+
+template<typename T>
+template<typename ... Ts>
+typename PatternMatcher<T>::Match PatternMatcher<T>::FirstMatch(const CustomString<T, Ts...>& haystack) const
+{
+	return FirstMatch(haystack.Data(), haystack.Size());
+}
+
+template<typename T>
+typename PatternMatcher<T>::Match PatternMatcher<T>::FirstMatch(const T* pHaystack, const size_t haystackSize) const
+{
+	uint32_t state{ RootState };
+
+	for (size_t i{}; i < haystackSize; ++i)
+	{
+		state = Step(state, pHaystack[i]);
+
+		if (const uint32_t outputState{ GetFirstOutput(state) }; outputState != RootState)
+			return MakeMatch(outputState, i + 1);
+	}
+
+	return Match{ NoPos, 0, 0 };
+}
+
+template<typename T>
+template<typename ... Ts>
+typename PatternMatcher<T>::MatchRange PatternMatcher<T>::Matches(const CustomString<T, Ts...>& haystack) const
+{
+	return Matches(haystack.Data(), haystack.Size());
+}
+
+template<typename T>
+typename PatternMatcher<T>::MatchRange PatternMatcher<T>::Matches(const T* pHaystack, const size_t haystackSize) const
+{
+	return MatchRange{ this, pHaystack, haystackSize };
+}
+
+#pragma endregion
+
+#pragma region Matcher_Information
+
+template<typename T>
+size_t PatternMatcher<T>::NrOfPatterns() const
+{
+	return m_PatternSizes.size();
+}
+
+template<typename T>
+size_t PatternMatcher<T>::NrOfStates() const
+{
+	return m_States.size();
+}
+
+template<typename T>
+size_t PatternMatcher<T>::NrOfCharacterClasses() const
+{
+	return m_NrOfClasses;
+}
+
+template<typename T>
+size_t PatternMatcher<T>::MemoryUsage() const
+{
+	return m_Transitions.capacity() * sizeof(uint32_t) + m_States.capacity() * sizeof(StateInfo)
+		+ m_PatternSizes.capacity() * sizeof(size_t) + m_Alphabet.capacity() * sizeof(T) + sizeof(*this);
+}
+
+#pragma endregion
+
+#pragma region Helpers
+
+template<typename T>
+void PatternMatcher<T>::BuildAlphabet(const T* pPattern, const size_t size)
+{
+	for (size_t i{}; i < size; ++i)
+	{
+		if constexpr (sizeof(T) == 1)
+		{
+			uint32_t& byteClass{ m_ByteClasses[static_cast<unsigned char>(pPattern[i])] };
+
+			if (byteClass == 0)
+				byteClass = static_cast<uint32_t>(m_NrOfClasses++);
+		}
+		else
+		{
+			m_Alphabet.push_back(pPattern[i]);
+		}
+	}
+}
+
+template<typename T>
+void PatternMatcher<T>::AddPattern(const T* pPattern, const size_t size, const uint32_t patternIndex)
+{
+	m_PatternSizes.push_back(size);
+
+	if (size == 0)
+		return;
+
+	uint32_t state{ RootState };
+
+	for (size_t i{}; i < size; ++i)
+	{
+		/* Before the failure links are built, RootState doubles as "no transition": the root is nobody's child */
+		const size_t index{ state * m_NrOfClasses + GetClass(pPattern[i]) };
+
+		if (m_Transitions[index] == RootState)
+		{
+			const uint32_t newState{ AddState() };
+			m_Transitions[index] = newState;
+		}
+
+		state = m_Transitions[index];
+	}
+
+	/* Duplicate patterns report the first one */
+	if (m_States[state].Pattern == NoPattern)
+		m_States[state].Pattern = patternIndex;
+}
+
+template<typename T>
+void PatternMatcher<T>::BuildFailureLinks()
+{
+	/* Breadth-first, so a state's failure target always has its row completed before the state itself.
+	   Missing transitions are filled in with those of the failure target, which turns the trie into a DFA */
+	std::vector<uint32_t> failureLinks(m_States.size(), RootState);
+	std::vector<uint32_t> queue{};
+	queue.reserve(m_States.size());
+
+	for (size_t c{}; c < m_NrOfClasses; ++c)
+	{
+		if (const uint32_t child{ m_Transitions[c] }; child != RootState)
+			queue.push_back(child);
+	}
+
+	for (size_t head{}; head < queue.size(); ++head)
+	{
+		const uint32_t state{ queue[head] };
+		const uint32_t failure{ failureLinks[state] };
+
+		for (size_t c{}; c < m_NrOfClasses; ++c)
+		{
+			uint32_t& transition{ m_Transitions[state * m_NrOfClasses + c] };
+			const uint32_t failureTransition{ m_Transitions[failure * m_NrOfClasses + c] };
+
+			if (transition == RootState)
+			{
+				transition = failureTransition;
+				continue;
+			}
+
+			failureLinks[transition] = failureTransition;
+
+			const StateInfo& failureInfo{ m_States[failureTransition] };
+			m_States[transition].OutputLink = failureInfo.Pattern != NoPattern ? failureTransition : failureInfo.OutputLink;
+
+			queue.push_back(transition);
+		}
+	}
+}
+
+template<typename T>
+uint32_t PatternMatcher<T>::AddState()
+{
+	assert(m_States.size() < std::numeric_limits<uint32_t>::max());
+
+	m_States.push_back(StateInfo{ NoPattern, RootState });
+	m_Transitions.resize(m_Transitions.size() + m_NrOfClasses, RootState);
+
+	return static_cast<uint32_t>(m_States.size() - 1);
+}
+
+template<typename T>
+uint32_t PatternMatcher<T>::GetClass(const T c) const
+{
+	if constexpr (sizeof(T) == 1)
+	{
+		return m_ByteClasses[static_cast<unsigned char>(c)];
+	}
+	else
+	{
+		const auto it{ std::lower_bound(m_Alphabet.begin(), m_Alphabet.end(), c) };
+
+		return it != m_Alphabet.end() && *it == c ? static_cast<uint32_t>(it - m_Alphabet.begin() + 1) : 0u;
+	}
+}
+
+template<typename T>
+uint32_t PatternMatcher<T>::Step(const uint32_t state, const T c) const
+{
+	return m_Transitions[state * m_NrOfClasses + GetClass(c)];
+}
+
+template<typename T>
+uint32_t PatternMatcher<T>::GetFirstOutput(const uint32_t state) const
+{
+	const StateInfo& info{ m_States[state] };
+
+	return info.Pattern != NoPattern ? state : info.OutputLink;
+}
+
+template<typename T>
+typename PatternMatcher<T>::Match PatternMatcher<T>::MakeMatch(const uint32_t outputState, const size_t end) const
+{
+	const uint32_t patternIndex{ m_States[outputState].Pattern };
+	const size_t size{ m_PatternSizes[patternIndex] };
+
+	return Match{ end - size, size, patternIndex };
+}
+
+#pragma endregion
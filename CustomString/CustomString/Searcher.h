@@ -0,0 +1,155 @@
+#pragma once
+
+#include "CustomString.h"
+
+#include <array> /* std::array */
+
+/* Precompiled Boyer-Moore-Horspool search for one needle. The skip table is built once,
+   so searching the same needle in many haystacks only pays for the scan itself.
+   Horspool is sublinear on typical text, but can degrade to O(n * m) on highly repetitive input:
+   IndexOf(const CustomString&) stays the better choice for untrusted needles */
+template<typename T>
+class Searcher final
+{
+public:
+	constexpr static size_t NoPos{ std::numeric_limits<size_t>::max() };
+
+#pragma region Ctors_Dtors
+
+	template<typename ... Ts>
+	explicit Searcher(const CustomString<T, Ts...>& needle);
+	explicit Searcher(const T* pNeedle);
+	Searcher(const T* pNeedle, const size_t count);
+
+#pragma endregion
+
+#pragma region Searching
+
+	template<typename ... Ts>
+	NODISCARD size_t FindIn(const CustomString<T, Ts...>& haystack) const;
+	NODISCARD size_t FindIn(const T* pHaystack, const size_t haystackSize) const;
+
+#pragma endregion
+
+#pragma region Searcher_Information
+
+	NODISCARD const CustomString<T>& GetNeedle() const;
+
+#pragma endregion
+
+private:
+	constexpr static size_t NrOfBuckets{ 256 };
+
+	void BuildSkipTable();
+	/* Wider characters share buckets, a bucket keeps the smallest shift of all its characters so skips stay safe */
+	NODISCARD constexpr static size_t GetBucket(const T c);
+
+	CustomString<T> m_Needle;
+	std::array<size_t, NrOfBuckets> m_SkipTable;
+};
+
+#pragma region Ctors_Dtors
+
+template<typename T>
+template<typename ... Ts>
+Searcher<T>::Searcher(const CustomString<T, Ts...>& needle)
+	: Searcher{ needle.Data(), needle.Size() }
+{}
+
+template<typename T>
+Searcher<T>::Searcher(const T* pNeedle)
+	: m_Needle{ pNeedle }
+	, m_SkipTable{}
+{
+	BuildSkipTable();
+}
+
+template<typename T>
+Searcher<T>::Searcher(const T* pNeedle, const size_t count)
+	: m_Needle{}
+	, m_SkipTable{}
+{
+	/* Assign(pStr, count) would drop a trailing null character, the needle keeps all count characters */
+	m_Needle.ResizeAndOverwrite(count, [pNeedle](T* pData, const size_t size)
+		{
+			std::memcpy(pData, pNeedle, size * sizeof(T));
+			return size;
+		});
+
+	BuildSkipTable();
+}
+
+#pragma endregion
+
+#pragma region Searching
+
+template<typename T>
+template<typename ... Ts>
+size_t Searcher<T>::FindIn(const CustomString<T, Ts...>& haystack) const
+{
+	return FindIn(haystack.Data(), haystack.Size());
+}
+
+template<typename T>
+size_t Searcher<T>::FindIn(const T* pHaystack, const size_t haystackSize) const
+{
+	const size_t needleSize{ m_Needle.Size() };
+
+	if (needleSize > haystackSize)
+		return NoPos;
+
+	if (needleSize == 0)
+		return pHaystack ? 0u : NoPos;
+
+	const T* pNeedle{ m_Needle.Data() };
+	const T last{ pNeedle[needleSize - 1] };
+	const size_t lastPosition{ haystackSize - needleSize };
+
+	for (size_t position{}; position <= lastPosition;)
+	{
+		/* The skip is decided by the haystack character under the end of the needle */
+		const T c{ pHaystack[position + needleSize - 1] };
+
+		if (c == last && std::memcmp(pHaystack + position, pNeedle, (needleSize - 1) * sizeof(T)) == 0)
+			return position;
+
+		position += m_SkipTable[GetBucket(c)];
+	}
+
+	return NoPos;
+}
+
+#pragma endregion
+
+#pragma region Searcher_Information
+
+template<typename T>
+const CustomString<T>& Searcher<T>::GetNeedle() const
+{
+	return m_Needle;
+}
+
+#pragma endregion
+
+#pragma region Helpers
+
+template<typename T>
+void Searcher<T>::BuildSkipTable()
+{
+	const size_t needleSize{ m_Needle.Size() };
+	const T* pNeedle{ m_Needle.Data() };
+
+	m_SkipTable.fill(needleSize);
+
+	/* The last character is left out: it would give a shift of 0 */
+	for (size_t i{}; i + 1 < needleSize; ++i)
+		m_SkipTable[GetBucket(pNeedle[i])] = needleSize - 1 - i;
+}
+
+template<typename T>
+constexpr size_t Searcher<T>::GetBucket(const T c)
+{
+	return static_cast<size_t>(c) & (NrOfBuckets - 1);
+}
+
+#pragma endregion
@@ -0,0 +1,306 @@
+#pragma once
+
+#include "CustomString.h"
+
+#include <atomic> /* std::atomic */
+#include <new> /* ::operator new */
+
+/* Frozen, immutable string. The reference count, size and hash live in the same allocation as the characters,
+   so copying is a pointer copy plus an atomic increment and copies can be handed to other threads freely. */
+template<typename T>
+class SharedString final
+{
+public:
+#pragma region Ctors_Dtors
+
+	SharedString() = default;
+	explicit SharedString(const T* pStr);
+	SharedString(const T* pStr, const size_t count);
+	template<typename ... Ts>
+	explicit SharedString(const CustomString<T, Ts...>& str);
+
+	~SharedString();
+
+#pragma endregion
+
+#pragma region RuleOf5
+
+	SharedString(const SharedString& other) noexcept;
+	SharedString(SharedString&& other) noexcept;
+	SharedString& operator=(const SharedString& other) noexcept;
+	SharedString& operator=(SharedString&& other) noexcept;
+
+#pragma endregion
+
+#pragma region String_Information
+
+	NODISCARD size_t Size() const;
+	NODISCARD const T* Data() const;
+	NODISCARD size_t Hash() const;
+	NODISCARD size_t UseCount() const;
+	NODISCARD CustomString<T> ToCustomString() const;
+
+#pragma endregion
+
+#pragma region Comparison
+
+	NODISCARD bool operator==(const SharedString& other) const;
+	NODISCARD bool operator==(const T* pStr) const;
+
+#pragma endregion
+
+#pragma region Element_Access
+
+	NODISCARD const T& operator[](const size_t index) const;
+
+#pragma endregion
+
+private:
+	struct Header final
+	{
+		std::atomic<size_t> RefCount;
+		size_t Size;
+		size_t Hash;
+		/* Followed by Size + 1 characters */
+	};
+
+	static_assert(alignof(Header) >= alignof(T), "The characters are stored straight after the header");
+
+#pragma region Helpers
+
+	NODISCARD static Header* CreateHeader(const T* pStr, const size_t size);
+	static void ReleaseHeader(Header* pHeader);
+	NODISCARD static T* GetCharacters(Header* pHeader);
+	NODISCARD static size_t HashCharacters(const T* pStr, const size_t size);
+
+#pragma endregion
+
+	Header* m_pHeader{}; // nullptr while the string is empty
+};
+
+#pragma region Ctors_Dtors
+
+template<typename T>
+SharedString<T>::SharedString(const T* pStr)
+{
+	assert(pStr != nullptr);
+
+	size_t size{};
+	while (pStr[size] != T())
+		++size;
+
+	m_pHeader = CreateHeader(pStr, size);
+}
+
+template<typename T>
+SharedString<T>::SharedString(const T* pStr, const size_t count)
+	: m_pHeader{ CreateHeader(pStr, count) }
+{}
+
+template<typename T>
+template<typename ... Ts>
+SharedString<T>::SharedString(const CustomString<T, Ts...>& str)
+	: m_pHeader{ CreateHeader(str.Data(), str.Size()) }
+{}
+
+template<typename T>
+SharedString<T>::~SharedString()
+{
+	ReleaseHeader(m_pHeader);
+}
+
+#pragma endregion
+
+#pragma region RuleOf5
+
+template<typename T>
+SharedString<T>::SharedString(const SharedString& other) noexcept
+	: m_pHeader{ other.m_pHeader }
+{
+	if (m_pHeader)
+		m_pHeader->RefCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename T>
+SharedString<T>::SharedString(SharedString&& other) noexcept
+	: m_pHeader{ other.m_pHeader }
+{
+	other.m_pHeader = nullptr;
+}
+
+template<typename T>
+SharedString<T>& SharedString<T>::operator=(const SharedString& other) noexcept
+{
+	if (m_pHeader == other.m_pHeader)
+		return *this;
+
+	if (other.m_pHeader)
+		other.m_pHeader->RefCount.fetch_add(1, std::memory_order_relaxed);
+
+	ReleaseHeader(m_pHeader);
+	m_pHeader = other.m_pHeader;
+
+	return *this;
+}
+
+template<typename T>
+SharedString<T>& SharedString<T>::operator=(SharedString&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	ReleaseHeader(m_pHeader);
+
+	m_pHeader = other.m_pHeader;
+	other.m_pHeader = nullptr;
+
+	return *this;
+}
+
+#pragma endregion
+
+#pragma region String_Information
+
+template<typename T>
+size_t SharedString<T>::Size() const
+{
+	return m_pHeader ? m_pHeader->Size : 0u;
+}
+
+template<typename T>
+const T* SharedString<T>::Data() const
+{
+	/* An empty string still hands out a valid, null-terminated string */
+	static constexpr T empty{};
+
+	return m_pHeader ? GetCharacters(m_pHeader) : &empty;
+}
+
+template<typename T>
+size_t SharedString<T>::Hash() const
+{
+	return m_pHeader ? m_pHeader->Hash : HashCharacters(nullptr, 0);
+}
+
+template<typename T>
+size_t SharedString<T>::UseCount() const
+{
+	return m_pHeader ? m_pHeader->RefCount.load(std::memory_order_relaxed) : 0u;
+}
+
+template<typename T>
+CustomString<T> SharedString<T>::ToCustomString() const
+{
+	CustomString<T> string{};
+
+	const size_t size{ Size() };
+	if (size == 0)
+		return string;
+
+	/* Assign(pStr, count) would drop a trailing null character, this copies exactly size characters */
+	string.ResizeAndOverwrite(size, [this](T* pData, const size_t count)
+		{
+			std::memcpy(pData, Data(), count * sizeof(T));
+			return count;
+		});
+
+	return string;
+}
+
+#pragma endregion
+
+#pragma region Comparison
+
+template<typename T>
+bool SharedString<T>::operator==(const SharedString& other) const
+{
+	if (m_pHeader == other.m_pHeader)
+		return true;
+
+	if (Size() != other.Size() || Hash() != other.Hash())
+		return false;
+
+	return std::memcmp(Data(), other.Data(), Size() * sizeof(T)) == 0;
+}
+
+template<typename T>
+bool SharedString<T>::operator==(const T* pStr) const
+{
+	assert(pStr != nullptr);
+
+	const T* pData{ Data() };
+	const size_t size{ Size() };
+
+	for (size_t i{}; i < size; ++i)
+	{
+		/* pStr ends at its first null, an embedded null in our characters must not read past it */
+		if (pStr[i] != pData[i] || pStr[i] == T())
+			return false;
+	}
+
+	return pStr[size] == T();
+}
+
+#pragma endregion
+
+#pragma region Element_Access
+
+template<typename T>
+const T& SharedString<T>::operator[](const size_t index) const
+{
+	assert(index < Size());
+
+	return Data()[index];
+}
+
+#pragma endregion
+
+#pragma region Helpers
+
+template<typename T>
+typename SharedString<T>::Header* SharedString<T>::CreateHeader(const T* pStr, const size_t size)
+{
+	if (size == 0)
+		return nullptr;
+
+	void* pMemory{ ::operator new(sizeof(Header) + (size + 1) * sizeof(T)) };
+
+	Header* pHeader{ new (pMemory) Header{} };
+	pHeader->RefCount.store(1, std::memory_order_relaxed);
+	pHeader->Size = size;
+	pHeader->Hash = HashCharacters(pStr, size);
+
+	T* pCharacters{ GetCharacters(pHeader) };
+	std::memcpy(pCharacters, pStr, size * sizeof(T));
+	pCharacters[size] = T();
+
+	return pHeader;
+}
+
+template<typename T>
+void SharedString<T>::ReleaseHeader(Header* pHeader)
+{
+	if (!pHeader)
+		return;
+
+	if (pHeader->RefCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return;
+
+	pHeader->~Header();
+	::operator delete(pHeader);
+}
+
+template<typename T>
+T* SharedString<T>::GetCharacters(Header* pHeader)
+{
+	return reinterpret_cast<T*>(pHeader + 1);
+}
+
+template<typename T>
+size_t SharedString<T>::HashCharacters(const T* pStr, const size_t size)
+{
+	/* The same hash as CustomString::Hash(), so a string hashes the same in every container */
+	return static_cast<size_t>(StringHash::Hash(pStr, size * sizeof(T)));
+}
+
+#pragma endregion
@@ -0,0 +1,128 @@
+#include "StringArena.h"
+
+#include <new> /* ::operator new */
+#include <cstdint> /* uintptr_t */
+#include <algorithm> /* std::max() */
+
+#pragma region Ctors_Dtors
+
+StringArena::StringArena(const size_t blockSize)
+	: m_BlockSize{ blockSize }
+	, m_pFirstBlock{}
+	, m_pCurrentBlock{}
+	, m_pCurrent{}
+	, m_pEnd{}
+	, m_BytesUsedInPreviousBlocks{}
+{
+	assert(blockSize > 0);
+}
+
+StringArena::~StringArena()
+{
+	Block* pBlock{ m_pFirstBlock };
+
+	while (pBlock)
+	{
+		Block* pNext{ pBlock->pNext };
+		::operator delete(pBlock);
+		pBlock = pNext;
+	}
+}
+
+#pragma endregion
+
+#pragma region Allocation
+
+void* StringArena::Allocate(const size_t size, const size_t alignment)
+{
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	const auto align = [alignment](std::byte* p)
+	{
+		const uintptr_t address{ reinterpret_cast<uintptr_t>(p) };
+		return p + (((address + alignment - 1) & ~(alignment - 1)) - address);
+	};
+
+	std::byte* pAligned{ m_pCurrent ? align(m_pCurrent) : nullptr };
+
+	if (!pAligned || pAligned > m_pEnd || size > static_cast<size_t>(m_pEnd - pAligned))
+	{
+		AddBlock(size + alignment);
+		pAligned = align(m_pCurrent);
+	}
+
+	m_pCurrent = pAligned + size;
+
+	return pAligned;
+}
+
+void StringArena::Reset()
+{
+	/* Blocks are kept around for the next round of allocations, so this is constant time */
+	m_pCurrentBlock = m_pFirstBlock;
+	m_pCurrent = m_pFirstBlock ? GetBlockData(m_pFirstBlock) : nullptr;
+	m_pEnd = m_pFirstBlock ? m_pCurrent + m_pFirstBlock->Size : nullptr;
+	m_BytesUsedInPreviousBlocks = 0;
+}
+
+#pragma endregion
+
+#pragma region Arena_Information
+
+size_t StringArena::BytesUsed() const
+{
+	if (!m_pCurrentBlock)
+		return 0;
+
+	return m_BytesUsedInPreviousBlocks + (m_pCurrent - GetBlockData(m_pCurrentBlock));
+}
+
+size_t StringArena::BytesReserved() const
+{
+	size_t total{};
+
+	for (Block* pBlock{ m_pFirstBlock }; pBlock; pBlock = pBlock->pNext)
+		total += pBlock->Size;
+
+	return total;
+}
+
+#pragma endregion
+
+#pragma region Blocks
+
+std::byte* StringArena::GetBlockData(Block* pBlock)
+{
+	return reinterpret_cast<std::byte*>(pBlock) + sizeof(Block);
+}
+
+void StringArena::AddBlock(const size_t minSize)
+{
+	if (m_pCurrentBlock)
+		m_BytesUsedInPreviousBlocks += m_pCurrent - GetBlockData(m_pCurrentBlock);
+
+	/* Reuse the blocks that are still around from before the last Reset() */
+	Block* pNext{ m_pCurrentBlock ? m_pCurrentBlock->pNext : m_pFirstBlock };
+
+	if (!pNext || pNext->Size < minSize)
+	{
+		const size_t size{ std::max(m_BlockSize, minSize) };
+
+		Block* pBlock{ static_cast<Block*>(::operator new(sizeof(Block) + size)) };
+		pBlock->pNext = pNext;
+		pBlock->Size = size;
+
+		if (m_pCurrentBlock)
+			m_pCurrentBlock->pNext = pBlock;
+		else
+			m_pFirstBlock = pBlock;
+
+		pNext = pBlock;
+	}
+
+	m_pCurrentBlock = pNext;
+	m_pCurrent = GetBlockData(pNext);
+	m_pEnd = m_pCurrent + pNext->Size;
+}
+
+#pragma endregion
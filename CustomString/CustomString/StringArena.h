@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CustomString.h"
+
+#include <cstddef> /* std::byte, std::max_align_t */
+#include <type_traits> /* std::false_type */
+
+/* Bump-pointer memory for strings that all die at the same time, e.g. at the end of a request.
+   Individual deallocations are ignored, Reset() hands all memory back to the arena at once. */
+class StringArena final
+{
+public:
+	constexpr static size_t DefaultBlockSize{ 64u * 1024u };
+
+#pragma region Ctors_Dtors
+
+	explicit StringArena(const size_t blockSize = DefaultBlockSize);
+
+	~StringArena();
+
+#pragma endregion
+
+#pragma region RuleOf5
+
+	StringArena(const StringArena&) noexcept = delete;
+	StringArena(StringArena&&) noexcept = delete;
+	StringArena& operator=(const StringArena&) noexcept = delete;
+	StringArena& operator=(StringArena&&) noexcept = delete;
+
+#pragma endregion
+
+#pragma region Allocation
+
+	NODISCARD void* Allocate(const size_t size, const size_t alignment);
+	void Reset();
+
+#pragma endregion
+
+#pragma region Arena_Information
+
+	NODISCARD size_t BytesUsed() const;
+	NODISCARD size_t BytesReserved() const;
+
+#pragma endregion
+
+private:
+	struct Block final
+	{
+		Block* pNext;
+		size_t Size; // Usable bytes following the header
+	};
+
+	NODISCARD static std::byte* GetBlockData(Block* pBlock);
+	void AddBlock(const size_t minSize);
+
+	size_t m_BlockSize;
+	Block* m_pFirstBlock;
+	Block* m_pCurrentBlock;
+	std::byte* m_pCurrent;
+	std::byte* m_pEnd;
+	size_t m_BytesUsedInPreviousBlocks;
+};
+
+template<typename T>
+class ArenaAllocator final
+{
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::false_type;
+	using propagate_on_container_swap = std::false_type;
+	using is_always_equal = std::false_type;
+
+	ArenaAllocator(StringArena& arena) noexcept
+		: m_pArena{ &arena }
+	{}
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+		: m_pArena{ other.GetArena() }
+	{}
+
+	NODISCARD T* allocate(const size_t n)
+	{
+		return static_cast<T*>(m_pArena->Allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T*, const size_t) noexcept
+	{
+		/* Memory only gets reclaimed by StringArena::Reset() */
+	}
+
+	NODISCARD StringArena* GetArena() const
+	{
+		return m_pArena;
+	}
+
+	template<typename U>
+	NODISCARD bool operator==(const ArenaAllocator<U>& other) const
+	{
+		return m_pArena == other.GetArena();
+	}
+
+private:
+	StringArena* m_pArena;
+};
+
+template<typename T>
+using ArenaString = CustomString<T, ArenaAllocator<T>>;
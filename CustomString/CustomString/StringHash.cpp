@@ -0,0 +1,153 @@
+#include "StringHash.h"
+
+#include <cstring> /* std::memcpy() */
+#include <random> /* std::random_device */
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h> /* _umul128() */
+#endif
+
+namespace
+{
+	using Byte = unsigned char;
+
+	constexpr uint64_t Secret[4]{ 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+	uint64_t Read8(const Byte* p)
+	{
+		uint64_t value;
+		std::memcpy(&value, p, sizeof(value));
+
+		return value;
+	}
+
+	uint64_t Read4(const Byte* p)
+	{
+		uint32_t value;
+		std::memcpy(&value, p, sizeof(value));
+
+		return value;
+	}
+
+	/* One to three bytes: the first, the middle and the last one, which may all be the same byte */
+	uint64_t Read3(const Byte* p, const size_t size)
+	{
+		return (uint64_t{ p[0] } << 16) | (uint64_t{ p[size >> 1] } << 8) | p[size - 1];
+	}
+
+	/* Full 128 bit product of a and b, the low half ends up in a and the high half in b */
+	void Multiply(uint64_t& a, uint64_t& b)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		a = _umul128(a, b, &b);
+#elif defined(__SIZEOF_INT128__)
+		const unsigned __int128 product{ static_cast<unsigned __int128>(a) * b };
+		a = static_cast<uint64_t>(product);
+		b = static_cast<uint64_t>(product >> 64);
+#else
+		const uint64_t aHigh{ a >> 32 };
+		const uint64_t aLow{ a & 0xFFFFFFFFu };
+		const uint64_t bHigh{ b >> 32 };
+		const uint64_t bLow{ b & 0xFFFFFFFFu };
+
+		const uint64_t low{ aLow * bLow };
+		const uint64_t middle1{ aHigh * bLow };
+		const uint64_t middle2{ aLow * bHigh };
+		const uint64_t high{ aHigh * bHigh };
+
+		const uint64_t carry{ ((low >> 32) + (middle1 & 0xFFFFFFFFu) + (middle2 & 0xFFFFFFFFu)) >> 32 };
+
+		a = low + (middle1 << 32) + (middle2 << 32);
+		b = high + (middle1 >> 32) + (middle2 >> 32) + carry;
+#endif
+	}
+
+	uint64_t Mix(uint64_t a, uint64_t b)
+	{
+		Multiply(a, b);
+
+		return a ^ b;
+	}
+}
+
+namespace StringHash
+{
+	uint64_t Hash(const void* pData, const size_t size, uint64_t seed)
+	{
+		const Byte* p{ static_cast<const Byte*>(pData) };
+
+		seed ^= Mix(seed ^ Secret[0], Secret[1]);
+
+		uint64_t a{};
+		uint64_t b{};
+
+		if (size <= 16)
+		{
+			if (size >= 4)
+			{
+				/* Two pairs of 4 byte loads that overlap as needed to cover all 4 to 16 bytes */
+				const size_t offset{ (size >> 3) << 2 };
+
+				a = (Read4(p) << 32) | Read4(p + offset);
+				b = (Read4(p + size - 4) << 32) | Read4(p + size - 4 - offset);
+			}
+			else if (size > 0)
+			{
+				a = Read3(p, size);
+			}
+		}
+		else
+		{
+			size_t remaining{ size };
+
+			if (remaining >= 48)
+			{
+				/* Three independent lanes keep the multipliers busy */
+				uint64_t seed1{ seed };
+				uint64_t seed2{ seed };
+
+				do
+				{
+					seed = Mix(Read8(p) ^ Secret[1], Read8(p + 8) ^ seed);
+					seed1 = Mix(Read8(p + 16) ^ Secret[2], Read8(p + 24) ^ seed1);
+					seed2 = Mix(Read8(p + 32) ^ Secret[3], Read8(p + 40) ^ seed2);
+
+					p += 48;
+					remaining -= 48;
+				} while (remaining >= 48);
+
+				seed ^= seed1 ^ seed2;
+			}
+
+			while (remaining > 16)
+			{
+				seed = Mix(Read8(p) ^ Secret[1], Read8(p + 8) ^ seed);
+
+				p += 16;
+				remaining -= 16;
+			}
+
+			/* The last 16 bytes, which may overlap with the ones already mixed in */
+			a = Read8(p + remaining - 16);
+			b = Read8(p + remaining - 8);
+		}
+
+		a ^= Secret[1];
+		b ^= seed;
+		Multiply(a, b);
+
+		return Mix(a ^ Secret[0] ^ size, b ^ Secret[1]);
+	}
+
+	uint64_t RandomSeed()
+	{
+		static const uint64_t seed{ []()
+			{
+				std::random_device device{};
+
+				return (uint64_t{ device() } << 32) ^ device();
+			}() };
+
+		return seed;
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef> /* size_t */
+#include <cstdint> /* uint64_t */
+
+#ifndef NODISCARD
+#define NODISCARD [[nodiscard]]
+#endif
+
+/* 64-bit hash for strings, in the style of wyhash: short inputs are read with a few overlapping loads,
+   long inputs in 48 byte strides over three independent lanes. Every step is one 64x64 -> 128 bit multiply
+   whose halves are folded together. Not cryptographic, but a secret seed makes collisions hard to construct */
+namespace StringHash
+{
+	constexpr uint64_t DefaultSeed{};
+
+	NODISCARD uint64_t Hash(const void* pData, const size_t size, const uint64_t seed = DefaultSeed);
+
+	/* Random seed, generated once per process. Use it for tables whose keys come from untrusted input */
+	NODISCARD uint64_t RandomSeed();
+}
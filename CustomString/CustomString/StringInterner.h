@@ -0,0 +1,408 @@
+#pragma once
+
+#include "CustomString.h"
+#include "StringArena.h"
+
+#include <new> /* placement new */
+#include <vector> /* std::vector */
+#include <cstdint> /* uint32_t */
+#include <iterator> /* std::iterator_traits, std::distance() */
+
+template<typename T>
+class StringInterner;
+
+/* Handle to a string owned by a StringInterner. Two handles from the same interner are equal
+   if and only if their contents are equal, so comparing them is a single pointer compare. */
+template<typename T>
+class InternedString final
+{
+public:
+	InternedString() = default;
+
+#pragma region String_Information
+
+	NODISCARD size_t Size() const;
+	NODISCARD const T* Data() const;
+	NODISCARD size_t Hash() const;
+	NODISCARD uint32_t GetId() const;
+
+#pragma endregion
+
+#pragma region Comparison
+
+	NODISCARD bool operator==(const InternedString& other) const;
+
+#pragma endregion
+
+private:
+	friend class StringInterner<T>;
+
+	struct Entry final
+	{
+		size_t Size;
+		size_t Hash;
+		uint32_t Id;
+		/* Followed by Size + 1 characters */
+	};
+
+	static_assert(alignof(Entry) >= alignof(T), "The characters are stored straight after the entry");
+
+	explicit InternedString(const Entry* pEntry);
+
+	NODISCARD static const T* GetCharacters(const Entry* pEntry);
+
+	const Entry* m_pEntry{}; // nullptr for the empty string
+};
+
+/* Deduplicating table of strings. Interned strings live in a StringArena and are never moved or freed
+   before the interner itself, so handles stay valid for the interner's whole lifetime.
+   Not thread-safe: intern up front, or guard the interner with a lock. */
+template<typename T>
+class StringInterner final
+{
+public:
+	using Handle = InternedString<T>;
+
+	constexpr static uint32_t EmptyId{ 0 }; // Id of the empty string, interned strings start at 1
+
+	struct MemoryUsage final
+	{
+		size_t StringBytes; // Bytes taken up by the interned entries themselves
+		size_t ArenaBytes; // Bytes reserved by the arena backing the entries
+		size_t TableBytes; // Bytes taken up by the hash table and the id lookup
+		NODISCARD size_t TotalBytes() const { return ArenaBytes + TableBytes; }
+	};
+
+#pragma region Ctors_Dtors
+
+	explicit StringInterner(const size_t blockSize = StringArena::DefaultBlockSize);
+
+	~StringInterner() = default;
+
+#pragma endregion
+
+#pragma region RuleOf5
+
+	StringInterner(const StringInterner&) noexcept = delete;
+	StringInterner(StringInterner&&) noexcept = delete;
+	StringInterner& operator=(const StringInterner&) noexcept = delete;
+	StringInterner& operator=(StringInterner&&) noexcept = delete;
+
+#pragma endregion
+
+#pragma region Interning
+
+	Handle Intern(const T* pStr);
+	Handle Intern(const T* pStr, const size_t count);
+	template<typename ... Ts>
+	Handle Intern(const CustomString<T, Ts...>& str);
+
+	/* Interns every string in [first, last) and writes the handles to out, in order */
+	template<typename InputIt, typename OutputIt>
+	OutputIt InternAll(InputIt first, InputIt last, OutputIt out);
+
+	void Reserve(const size_t nrOfStrings);
+
+#pragma endregion
+
+#pragma region Lookup
+
+	/* Returns an empty handle if the string was never interned */
+	NODISCARD Handle Find(const T* pStr) const;
+	NODISCARD Handle Find(const T* pStr, const size_t count) const;
+	NODISCARD Handle FromId(const uint32_t id) const;
+
+#pragma endregion
+
+#pragma region Interner_Information
+
+	NODISCARD size_t Size() const;
+	NODISCARD MemoryUsage GetMemoryUsage() const;
+
+#pragma endregion
+
+private:
+	using Entry = typename Handle::Entry;
+
+	constexpr static size_t MinTableSize{ 16 };
+
+#pragma region Helpers
+
+	NODISCARD size_t FindSlot(const T* pStr, const size_t count, const size_t hash) const;
+	NODISCARD const Entry* CreateEntry(const T* pStr, const size_t count, const size_t hash);
+	void Rehash(const size_t newTableSize);
+	NODISCARD static size_t HashCharacters(const T* pStr, const size_t count);
+	NODISCARD static size_t CountCharacters(const T* pStr);
+
+#pragma endregion
+
+	StringArena m_Arena;
+	std::vector<const Entry*> m_Table; // Open addressing with linear probing, size is always a power of two
+	std::vector<const Entry*> m_Entries; // Indexed by id - 1
+};
+
+#pragma region InternedString
+
+template<typename T>
+InternedString<T>::InternedString(const Entry* pEntry)
+	: m_pEntry{ pEntry }
+{}
+
+template<typename T>
+size_t InternedString<T>::Size() const
+{
+	return m_pEntry ? m_pEntry->Size : 0u;
+}
+
+template<typename T>
+const T* InternedString<T>::Data() const
+{
+	/* The empty handle still hands out a valid, null-terminated string */
+	static constexpr T empty{};
+
+	return m_pEntry ? GetCharacters(m_pEntry) : &empty;
+}
+
+template<typename T>
+size_t InternedString<T>::Hash() const
+{
+	/* The empty handle hashes like every other empty string */
+	return m_pEntry ? m_pEntry->Hash : static_cast<size_t>(StringHash::Hash(nullptr, 0));
+}
+
+template<typename T>
+uint32_t InternedString<T>::GetId() const
+{
+	return m_pEntry ? m_pEntry->Id : StringInterner<T>::EmptyId;
+}
+
+template<typename T>
+bool InternedString<T>::operator==(const InternedString& other) const
+{
+	return m_pEntry == other.m_pEntry;
+}
+
+template<typename T>
+const T* InternedString<T>::GetCharacters(const Entry* pEntry)
+{
+	return reinterpret_cast<const T*>(pEntry + 1);
+}
+
+#pragma endregion
+
+#pragma region Ctors_Dtors
+
+template<typename T>
+StringInterner<T>::StringInterner(const size_t blockSize)
+	: m_Arena{ blockSize }
+	, m_Table{}
+	, m_Entries{}
+{}
+
+#pragma endregion
+
+#pragma region Interning
+
+template<typename T>
+typename StringInterner<T>::Handle StringInterner<T>::Intern(const T* pStr)
+{
+	assert(pStr != nullptr);
+
+	return Intern(pStr, CountCharacters(pStr));
+}
+
+template<typename T>
+typename StringInterner<T>::Handle StringInterner<T>::Intern(const T* pStr, const size_t count)
+{
+	if (count == 0)
+		return Handle{};
+
+	const size_t hash{ HashCharacters(pStr, count) };
+
+	/* Strings that are interned already are found without touching the table size */
+	size_t slot{};
+	if (!m_Table.empty())
+	{
+		slot = FindSlot(pStr, count, hash);
+
+		if (const Entry* pEntry{ m_Table[slot] }; pEntry)
+			return Handle{ pEntry };
+	}
+
+	/* Keep the load factor at or below 1/2, growing moves every entry so the free slot has to be found again */
+	if ((m_Entries.size() + 1) * 2 > m_Table.size())
+	{
+		Rehash(std::max(MinTableSize, m_Table.size() * 2));
+		slot = FindSlot(pStr, count, hash);
+	}
+
+	const Entry*& pSlot{ m_Table[slot] };
+	pSlot = CreateEntry(pStr, count, hash);
+
+	return Handle{ pSlot };
+}
+
+template<typename T>
+template<typename ... Ts>
+typename StringInterner<T>::Handle StringInterner<T>::Intern(const CustomString<T, Ts...>& str)
+{
+	return Intern(str.Data(), str.Size());
+}
+
+template<typename T>
+template<typename InputIt, typename OutputIt>
+OutputIt StringInterner<T>::InternAll(InputIt first, InputIt last, OutputIt out)
+{
+	/* Size the table once up front instead of rehashing along the way */
+	if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+		Reserve(m_Entries.size() + static_cast<size_t>(std::distance(first, last)));
+
+	for (; first != last; ++first, ++out)
+		*out = Intern(*first);
+
+	return out;
+}
+
+template<typename T>
+void StringInterner<T>::Reserve(const size_t nrOfStrings)
+{
+	size_t tableSize{ std::max(MinTableSize, m_Table.size()) };
+
+	while (tableSize < nrOfStrings * 2)
+		tableSize *= 2;
+
+	if (tableSize != m_Table.size())
+		Rehash(tableSize);
+
+	m_Entries.reserve(nrOfStrings);
+}
+
+#pragma endregion
+
+#pragma region Lookup
+
+template<typename T>
+typename StringInterner<T>::Handle StringInterner<T>::Find(const T* pStr) const
+{
+	assert(pStr != nullptr);
+
+	return Find(pStr, CountCharacters(pStr));
+}
+
+template<typename T>
+typename StringInterner<T>::Handle StringInterner<T>::Find(const T* pStr, const size_t count) const
+{
+	if (count == 0 || m_Table.empty())
+		return Handle{};
+
+	return Handle{ m_Table[FindSlot(pStr, count, HashCharacters(pStr, count))] };
+}
+
+template<typename T>
+typename StringInterner<T>::Handle StringInterner<T>::FromId(const uint32_t id) const
+{
+	assert(id <= m_Entries.size());
+
+	return id == EmptyId ? Handle{} : Handle{ m_Entries[id - 1] };
+}
+
+#pragma endregion
+
+#pragma region Interner_Information
+
+template<typename T>
+size_t StringInterner<T>::Size() const
+{
+	return m_Entries.size();
+}
+
+template<typename T>
+typename StringInterner<T>::MemoryUsage StringInterner<T>::GetMemoryUsage() const
+{
+	return MemoryUsage
+	{
+		m_Arena.BytesUsed(),
+		m_Arena.BytesReserved(),
+		(m_Table.capacity() + m_Entries.capacity()) * sizeof(const Entry*)
+	};
+}
+
+#pragma endregion
+
+#pragma region Helpers
+
+template<typename T>
+size_t StringInterner<T>::FindSlot(const T* pStr, const size_t count, const size_t hash) const
+{
+	/* Returns the index of the slot holding the string, or of the empty slot it would go in */
+	const size_t mask{ m_Table.size() - 1 };
+
+	for (size_t index{ hash & mask };; index = (index + 1) & mask)
+	{
+		const Entry* pEntry{ m_Table[index] };
+
+		if (!pEntry)
+			return index;
+
+		if (pEntry->Hash == hash && pEntry->Size == count && std::memcmp(Handle::GetCharacters(pEntry), pStr, count * sizeof(T)) == 0)
+			return index;
+	}
+}
+
+template<typename T>
+const typename StringInterner<T>::Entry* StringInterner<T>::CreateEntry(const T* pStr, const size_t count, const size_t hash)
+{
+	assert(m_Entries.size() < std::numeric_limits<uint32_t>::max());
+
+	void* pMemory{ m_Arena.Allocate(sizeof(Entry) + (count + 1) * sizeof(T), alignof(Entry)) };
+
+	Entry* pEntry{ new (pMemory) Entry{ count, hash, static_cast<uint32_t>(m_Entries.size() + 1) } };
+
+	T* pCharacters{ reinterpret_cast<T*>(pEntry + 1) };
+	std::memcpy(pCharacters, pStr, count * sizeof(T));
+	pCharacters[count] = T();
+
+	m_Entries.push_back(pEntry);
+
+	return pEntry;
+}
+
+template<typename T>
+void StringInterner<T>::Rehash(const size_t newTableSize)
+{
+	assert((newTableSize & (newTableSize - 1)) == 0);
+
+	m_Table.assign(newTableSize, nullptr);
+
+	const size_t mask{ newTableSize - 1 };
+
+	for (const Entry* pEntry : m_Entries)
+	{
+		size_t index{ pEntry->Hash & mask };
+
+		while (m_Table[index])
+			index = (index + 1) & mask;
+
+		m_Table[index] = pEntry;
+	}
+}
+
+template<typename T>
+size_t StringInterner<T>::HashCharacters(const T* pStr, const size_t count)
+{
+	/* The same hash as CustomString::Hash(), so a string hashes the same in every container */
+	return static_cast<size_t>(StringHash::Hash(pStr, count * sizeof(T)));
+}
+
+template<typename T>
+size_t StringInterner<T>::CountCharacters(const T* pStr)
+{
+	size_t size{};
+
+	while (pStr[size] != T())
+		++size;
+
+	return size;
+}
+
+#pragma endregion
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CustomString.h"
+#include "StringHash.h"
+#include "StringSearch.h"
+
+#include <string_view> /* std::basic_string_view */
+
+/* Transparent hash and equality for unordered containers keyed by CustomString:
+   std::unordered_map<CustomString<char>, V, CustomStringHash<char>, CustomStringEqual<char>>.
+   Both accept a CustomString of any Alloc, GrowthPolicy and HashCache, a null-terminated string and a std::basic_string_view,
+   so find(), count() and contains() can look up a const T* or a view without building a temporary key */
+template<typename T>
+struct CustomStringHash final
+{
+	using is_transparent = void;
+
+	/* Every overload hashes the same bytes as CustomString::Hash(), so all three agree on equal contents */
+	template<typename ... Ts>
+	NODISCARD size_t operator()(const CustomString<T, Ts...>& str) const
+	{
+		return str.Hash();
+	}
+
+	NODISCARD size_t operator()(const T* pStr) const
+	{
+		return (*this)(std::basic_string_view<T>{ pStr });
+	}
+
+	NODISCARD size_t operator()(const std::basic_string_view<T> str) const
+	{
+		return static_cast<size_t>(StringHash::Hash(str.data(), str.size() * sizeof(T)));
+	}
+};
+
+template<typename T>
+struct CustomStringEqual final
+{
+	using is_transparent = void;
+
+	template<typename ... Ts>
+	NODISCARD bool operator()(const CustomString<T, Ts...>& a, const CustomString<T, Ts...>& b) const
+	{
+		/* Same type on both sides, which lets cached hashes reject early */
+		return a == b;
+	}
+
+	template<typename A, typename B>
+	NODISCARD bool operator()(const A& a, const B& b) const
+	{
+		const std::basic_string_view<T> viewA{ ToView(a) };
+		const std::basic_string_view<T> viewB{ ToView(b) };
+
+		return viewA.size() == viewB.size() && StringSearch::Equals(viewA.data(), viewB.data(), viewA.size() * sizeof(T));
+	}
+
+private:
+	template<typename ... Ts>
+	NODISCARD static std::basic_string_view<T> ToView(const CustomString<T, Ts...>& str)
+	{
+		return std::basic_string_view<T>{ str.Data(), str.Size() };
+	}
+
+	NODISCARD static std::basic_string_view<T> ToView(const T* pStr)
+	{
+		return std::basic_string_view<T>{ pStr };
+	}
+
+	NODISCARD static std::basic_string_view<T> ToView(const std::basic_string_view<T> str)
+	{
+		return str;
+	}
+};
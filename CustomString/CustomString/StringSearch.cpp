@@ -0,0 +1,1233 @@
+#include "StringSearch.h"
+
+#include <assert.h> /* assert() */
+#include <bit> /* std::countr_zero(), std::countl_zero(), std::endian */
+#include <cstring> /* std::memcmp(), std::memcpy() */
+#include <cstdint> /* uint64_t */
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define STRING_SEARCH_X86
+#include <immintrin.h> /* SSE2, SSSE3 and AVX2 intrinsics */
+#ifdef _MSC_VER
+#include <intrin.h> /* __cpuid(), __cpuidex() */
+#endif
+#endif
+
+/* MSVC hands out every intrinsic regardless of /arch, GCC and Clang need the target enabled per function */
+#if defined(STRING_SEARCH_X86) && !defined(_MSC_VER)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_SSSE3
+#define TARGET_AVX2
+#endif
+
+namespace
+{
+	using namespace StringSearch;
+
+	using Byte = unsigned char;
+
+	/* Below this many bytes setting up the vector registers costs more than it saves */
+	constexpr size_t MinVectorSize{ 16 };
+
+#pragma region Detection
+
+	InstructionSet DetectInstructionSet()
+	{
+#if defined(STRING_SEARCH_X86) && defined(_MSC_VER)
+		int info[4]{};
+
+		__cpuid(info, 0);
+		const int maxLeaf{ info[0] };
+
+		__cpuid(info, 1);
+		const bool hasSSE2{ (info[3] & (1 << 26)) != 0 };
+		const bool hasSSSE3{ (info[2] & (1 << 9)) != 0 };
+		const bool hasOSXSave{ (info[2] & (1 << 27)) != 0 };
+		const bool hasAVX{ (info[2] & (1 << 28)) != 0 };
+
+		bool hasAVX2{};
+		if (maxLeaf >= 7 && hasOSXSave && hasAVX)
+		{
+			/* The OS has to save the YMM registers on context switches as well */
+			const bool osSavesYMM{ (_xgetbv(0) & 0x6) == 0x6 };
+
+			__cpuidex(info, 7, 0);
+			hasAVX2 = osSavesYMM && (info[1] & (1 << 5)) != 0;
+		}
+
+		if (hasAVX2)
+			return InstructionSet::AVX2;
+
+		if (hasSSSE3)
+			return InstructionSet::SSSE3;
+
+		return hasSSE2 ? InstructionSet::SSE2 : InstructionSet::Scalar;
+#elif defined(STRING_SEARCH_X86)
+		__builtin_cpu_init();
+
+		if (__builtin_cpu_supports("avx2"))
+			return InstructionSet::AVX2;
+
+		if (__builtin_cpu_supports("ssse3"))
+			return InstructionSet::SSSE3;
+
+		return __builtin_cpu_supports("sse2") ? InstructionSet::SSE2 : InstructionSet::Scalar;
+#else
+		return InstructionSet::Scalar;
+#endif
+	}
+
+#pragma endregion
+
+#pragma region FindByte
+
+	const Byte* FindByteScalar(const Byte* pData, const size_t size, const Byte value)
+	{
+		for (size_t i{}; i < size; ++i)
+		{
+			if (pData[i] == value)
+				return pData + i;
+		}
+
+		return nullptr;
+	}
+
+#ifdef STRING_SEARCH_X86
+	/* Lambdas do not inherit the target of the function they are in, so the per-vector steps are separate functions */
+	TARGET_SSE2 unsigned MatchMaskSSE2(const Byte* p, const __m128i needle)
+	{
+		return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), needle)));
+	}
+
+	TARGET_AVX2 __m256i CompareAVX2(const Byte* p, const __m256i needle)
+	{
+		return _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), needle);
+	}
+
+	TARGET_AVX2 unsigned MatchMaskAVX2(const Byte* p, const __m256i needle)
+	{
+		return static_cast<unsigned>(_mm256_movemask_epi8(CompareAVX2(p, needle)));
+	}
+
+	TARGET_SSE2 const Byte* FindByteSSE2(const Byte* pData, const size_t size, const Byte value)
+	{
+		if (size < 16)
+			return FindByteScalar(pData, size, value);
+
+		const __m128i needle{ _mm_set1_epi8(static_cast<char>(value)) };
+		const Byte* const pEnd{ pData + size };
+
+		const Byte* p{ pData };
+		for (; pEnd - p >= 16; p += 16)
+		{
+			if (const unsigned mask{ MatchMaskSSE2(p, needle) }; mask != 0)
+				return p + std::countr_zero(mask);
+		}
+
+		if (p == pEnd)
+			return nullptr;
+
+		/* Finish with one overlapping load, everything before p is already known not to match */
+		p = pEnd - 16;
+		const unsigned mask{ MatchMaskSSE2(p, needle) };
+
+		return mask != 0 ? p + std::countr_zero(mask) : nullptr;
+	}
+
+	TARGET_AVX2 const Byte* FindByteAVX2(const Byte* pData, const size_t size, const Byte value)
+	{
+		if (size < 32)
+			return FindByteSSE2(pData, size, value);
+
+		const __m256i needle{ _mm256_set1_epi8(static_cast<char>(value)) };
+		const Byte* const pEnd{ pData + size };
+
+		const Byte* p{ pData };
+
+		/* Two vectors per iteration, only the combined result is branched on */
+		for (; pEnd - p >= 64; p += 64)
+		{
+			const __m256i first{ CompareAVX2(p, needle) };
+			const __m256i second{ CompareAVX2(p + 32, needle) };
+			const __m256i any{ _mm256_or_si256(first, second) };
+
+			if (_mm256_testz_si256(any, any))
+				continue;
+
+			if (const unsigned mask{ static_cast<unsigned>(_mm256_movemask_epi8(first)) }; mask != 0)
+				return p + std::countr_zero(mask);
+
+			return p + 32 + std::countr_zero(static_cast<unsigned>(_mm256_movemask_epi8(second)));
+		}
+
+		for (; pEnd - p >= 32; p += 32)
+		{
+			if (const unsigned mask{ MatchMaskAVX2(p, needle) }; mask != 0)
+				return p + std::countr_zero(mask);
+		}
+
+		if (p == pEnd)
+			return nullptr;
+
+		p = pEnd - 32;
+		const unsigned mask{ MatchMaskAVX2(p, needle) };
+
+		return mask != 0 ? p + std::countr_zero(mask) : nullptr;
+	}
+#endif
+
+#pragma endregion
+
+#pragma region FindBytes
+
+	/* Verifying a false candidate costs up to needleSize compares. Once the verification work outgrows
+	   the bytes scanned so far by this factor, the filter is not paying off and Two-Way takes over */
+	constexpr size_t MaxVerificationFactor{ 4 };
+	constexpr size_t VerificationAllowance{ 1024 };
+
+	bool IsVerificationTooExpensive(const size_t verifiedBytes, const size_t scannedBytes)
+	{
+		return verifiedBytes > scannedBytes * MaxVerificationFactor + VerificationAllowance;
+	}
+
+	const Byte* FindBytesTwoWay(const Byte* pHaystack, const size_t haystackSize, const Byte* pNeedle, const size_t needleSize)
+	{
+		return FindSubstring(pHaystack, haystackSize, pNeedle, needleSize);
+	}
+
+#ifdef STRING_SEARCH_X86
+	TARGET_SSE2 const Byte* FindBytesSSE2(const Byte* pHaystack, const size_t haystackSize, const Byte* pNeedle, const size_t needleSize)
+	{
+		assert(needleSize >= 2);
+
+		const __m128i first{ _mm_set1_epi8(static_cast<char>(pNeedle[0])) };
+		const __m128i last{ _mm_set1_epi8(static_cast<char>(pNeedle[needleSize - 1])) };
+
+		size_t verifiedBytes{};
+		size_t i{};
+
+		/* Both loads have to stay within the haystack */
+		while (i + needleSize - 1 + 16 <= haystackSize)
+		{
+			const __m128i firstBlock{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pHaystack + i)) };
+			const __m128i lastBlock{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pHaystack + i + needleSize - 1)) };
+
+			unsigned mask{ static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(firstBlock, first), _mm_cmpeq_epi8(lastBlock, last)))) };
+
+			while (mask != 0)
+			{
+				const size_t position{ i + std::countr_zero(mask) };
+
+				if (std::memcmp(pHaystack + position + 1, pNeedle + 1, needleSize - 2) == 0)
+					return pHaystack + position;
+
+				verifiedBytes += needleSize;
+				mask &= mask - 1;
+			}
+
+			/* The fallback picks up after this block, which has been checked completely */
+			i += 16;
+
+			if (IsVerificationTooExpensive(verifiedBytes, i))
+				break;
+		}
+
+		return FindBytesTwoWay(pHaystack + i, haystackSize - i, pNeedle, needleSize);
+	}
+
+	TARGET_AVX2 const Byte* FindBytesAVX2(const Byte* pHaystack, const size_t haystackSize, const Byte* pNeedle, const size_t needleSize)
+	{
+		assert(needleSize >= 2);
+
+		const __m256i first{ _mm256_set1_epi8(static_cast<char>(pNeedle[0])) };
+		const __m256i last{ _mm256_set1_epi8(static_cast<char>(pNeedle[needleSize - 1])) };
+
+		size_t verifiedBytes{};
+		size_t i{};
+
+		while (i + needleSize - 1 + 32 <= haystackSize)
+		{
+			const __m256i firstBlock{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pHaystack + i)) };
+			const __m256i lastBlock{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pHaystack + i + needleSize - 1)) };
+
+			unsigned mask{ static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(firstBlock, first), _mm256_cmpeq_epi8(lastBlock, last)))) };
+
+			while (mask != 0)
+			{
+				const size_t position{ i + std::countr_zero(mask) };
+
+				if (std::memcmp(pHaystack + position + 1, pNeedle + 1, needleSize - 2) == 0)
+					return pHaystack + position;
+
+				verifiedBytes += needleSize;
+				mask &= mask - 1;
+			}
+
+			i += 32;
+
+			if (IsVerificationTooExpensive(verifiedBytes, i))
+				break;
+		}
+
+		return FindBytesTwoWay(pHaystack + i, haystackSize - i, pNeedle, needleSize);
+	}
+#endif
+
+#pragma endregion
+
+#pragma region FindLastByte
+
+	const Byte* FindLastByteScalar(const Byte* pData, const size_t size, const Byte value)
+	{
+		for (size_t i{ size }; i > 0; --i)
+		{
+			if (pData[i - 1] == value)
+				return pData + i - 1;
+		}
+
+		return nullptr;
+	}
+
+	/* Index of the highest set bit, i.e. the last match within a block */
+	size_t LastMatch(const unsigned mask)
+	{
+		return 31u - static_cast<size_t>(std::countl_zero(mask));
+	}
+
+#ifdef STRING_SEARCH_X86
+	TARGET_SSE2 const Byte* FindLastByteSSE2(const Byte* pData, const size_t size, const Byte value)
+	{
+		if (size < 16)
+			return FindLastByteScalar(pData, size, value);
+
+		const __m128i needle{ _mm_set1_epi8(static_cast<char>(value)) };
+
+		const Byte* p{ pData + size };
+		while (p - pData >= 16)
+		{
+			p -= 16;
+
+			if (const unsigned mask{ MatchMaskSSE2(p, needle) }; mask != 0)
+				return p + LastMatch(mask);
+		}
+
+		if (p == pData)
+			return nullptr;
+
+		/* Finish with one overlapping load, everything from p onwards is already known not to match */
+		const unsigned mask{ MatchMaskSSE2(pData, needle) };
+
+		return mask != 0 ? pData + LastMatch(mask) : nullptr;
+	}
+
+	TARGET_AVX2 const Byte* FindLastByteAVX2(const Byte* pData, const size_t size, const Byte value)
+	{
+		if (size < 32)
+			return FindLastByteSSE2(pData, size, value);
+
+		const __m256i needle{ _mm256_set1_epi8(static_cast<char>(value)) };
+
+		const Byte* p{ pData + size };
+
+		while (p - pData >= 64)
+		{
+			p -= 64;
+
+			const __m256i first{ CompareAVX2(p, needle) };
+			const __m256i second{ CompareAVX2(p + 32, needle) };
+			const __m256i any{ _mm256_or_si256(first, second) };
+
+			if (_mm256_testz_si256(any, any))
+				continue;
+
+			if (const unsigned mask{ static_cast<unsigned>(_mm256_movemask_epi8(second)) }; mask != 0)
+				return p + 32 + LastMatch(mask);
+
+			return p + LastMatch(static_cast<unsigned>(_mm256_movemask_epi8(first)));
+		}
+
+		while (p - pData >= 32)
+		{
+			p -= 32;
+
+			if (const unsigned mask{ MatchMaskAVX2(p, needle) }; mask != 0)
+				return p + LastMatch(mask);
+		}
+
+		if (p == pData)
+			return nullptr;
+
+		const unsigned mask{ MatchMaskAVX2(pData, needle) };
+
+		return mask != 0 ? pData + LastMatch(mask) : nullptr;
+	}
+#endif
+
+#pragma endregion
+
+#pragma region FindLastBytes
+
+	const Byte* FindLastBytesTwoWay(const Byte* pHaystack, const size_t haystackSize, const Byte* pNeedle, const size_t needleSize)
+	{
+		return FindLastSubstring(pHaystack, haystackSize, pNeedle, needleSize);
+	}
+
+#ifdef STRING_SEARCH_X86
+	TARGET_SSE2 const Byte* FindLastBytesSSE2(const Byte* pHaystack, const size_t haystackSize, const Byte* pNeedle, const size_t needleSize)
+	{
+		assert(needleSize >= 2 && needleSize <= haystackSize);
+
+		const __m128i first{ _mm_set1_epi8(static_cast<char>(pNeedle[0])) };
+		const __m128i last{ _mm_set1_epi8(static_cast<char>(pNeedle[needleSize - 1])) };
+
+		const size_t nrOfPositions{ haystackSize - needleSize + 1 };
+		size_t verifiedBytes{};
+
+		/* Positions [0, remaining) have not been checked yet */
+		size_t remaining{ nrOfPositions };
+		while (remaining >= 16)
+		{
+			const size_t i{ remaining - 16 };
+
+			const __m128i firstBlock{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pHaystack + i)) };
+			const __m128i lastBlock{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pHaystack + i + needleSize - 1)) };
+
+			unsigned mask{ static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(firstBlock, first), _mm_cmpeq_epi8(lastBlock, last)))) };
+
+			while (mask != 0)
+			{
+				const size_t bit{ LastMatch(mask) };
+				const size_t position{ i + bit };
+
+				if (std::memcmp(pHaystack + position + 1, pNeedle + 1, needleSize - 2) == 0)
+					return pHaystack + position;
+
+				verifiedBytes += needleSize;
+				mask &= ~(1u << bit);
+			}
+
+			/* The fallback picks up before this block, which has been checked completely */
+			remaining -= 16;
+
+			if (IsVerificationTooExpensive(verifiedBytes, nrOfPositions - remaining))
+				break;
+		}
+
+		if (remaining == 0)
+			return nullptr;
+
+		return FindLastBytesTwoWay(pHaystack, remaining + needleSize - 1, pNeedle, needleSize);
+	}
+
+	TARGET_AVX2 const Byte* FindLastBytesAVX2(const Byte* pHaystack, const size_t haystackSize, const Byte* pNeedle, const size_t needleSize)
+	{
+		assert(needleSize >= 2 && needleSize <= haystackSize);
+
+		const __m256i first{ _mm256_set1_epi8(static_cast<char>(pNeedle[0])) };
+		const __m256i last{ _mm256_set1_epi8(static_cast<char>(pNeedle[needleSize - 1])) };
+
+		const size_t nrOfPositions{ haystackSize - needleSize + 1 };
+		size_t verifiedBytes{};
+
+		size_t remaining{ nrOfPositions };
+		while (remaining >= 32)
+		{
+			const size_t i{ remaining - 32 };
+
+			const __m256i firstBlock{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pHaystack + i)) };
+			const __m256i lastBlock{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pHaystack + i + needleSize - 1)) };
+
+			unsigned mask{ static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(firstBlock, first), _mm256_cmpeq_epi8(lastBlock, last)))) };
+
+			while (mask != 0)
+			{
+				const size_t bit{ LastMatch(mask) };
+				const size_t position{ i + bit };
+
+				if (std::memcmp(pHaystack + position + 1, pNeedle + 1, needleSize - 2) == 0)
+					return pHaystack + position;
+
+				verifiedBytes += needleSize;
+				mask &= ~(1u << bit);
+			}
+
+			remaining -= 32;
+
+			if (IsVerificationTooExpensive(verifiedBytes, nrOfPositions - remaining))
+				break;
+		}
+
+		if (remaining == 0)
+			return nullptr;
+
+		return FindLastBytesTwoWay(pHaystack, remaining + needleSize - 1, pNeedle, needleSize);
+	}
+#endif
+
+#pragma endregion
+
+#pragma region FindAnyOf
+
+	const Byte* FindAnyOfScalar(const Byte* pData, const size_t size, const CharSet& set, const bool inSet)
+	{
+		for (size_t i{}; i < size; ++i)
+		{
+			if (set.Contains(pData[i]) == inSet)
+				return pData + i;
+		}
+
+		return nullptr;
+	}
+
+#ifdef STRING_SEARCH_X86
+	/* Classification of 16 bytes: the low nibble picks a bitmap entry, the high nibble picks the bit within it */
+	struct NibbleTablesSSSE3 final
+	{
+		__m128i LowHalf; // Entries for high nibbles 0-7
+		__m128i HighHalf; // Entries for high nibbles 8-15
+		__m128i Bits; // 1 << (high nibble & 7)
+	};
+
+	TARGET_SSSE3 NibbleTablesSSSE3 LoadNibbleTablesSSSE3(const CharSet& set)
+	{
+		const CharSet::Bitmap& bitmap{ set.GetBitmap() };
+
+		return NibbleTablesSSSE3
+		{
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(bitmap.data())),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(bitmap.data() + 16)),
+			_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128)
+		};
+	}
+
+	TARGET_SSSE3 unsigned ClassifySSSE3(const Byte* p, const NibbleTablesSSSE3& tables)
+	{
+		const __m128i nibbleMask{ _mm_set1_epi8(0x0F) };
+
+		const __m128i bytes{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) };
+		const __m128i lowNibbles{ _mm_and_si128(bytes, nibbleMask) };
+		const __m128i highNibbles{ _mm_and_si128(_mm_srli_epi16(bytes, 4), nibbleMask) };
+
+		const __m128i lowHalf{ _mm_shuffle_epi8(tables.LowHalf, lowNibbles) };
+		const __m128i highHalf{ _mm_shuffle_epi8(tables.HighHalf, lowNibbles) };
+		const __m128i isLowHalf{ _mm_cmplt_epi8(highNibbles, _mm_set1_epi8(8)) };
+		const __m128i entries{ _mm_or_si128(_mm_and_si128(isLowHalf, lowHalf), _mm_andnot_si128(isLowHalf, highHalf)) };
+
+		const __m128i bits{ _mm_shuffle_epi8(tables.Bits, highNibbles) };
+
+		return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(entries, bits), bits)));
+	}
+
+	TARGET_SSSE3 const Byte* FindAnyOfSSSE3(const Byte* pData, const size_t size, const CharSet& set, const bool inSet)
+	{
+		if (size < 16)
+			return FindAnyOfScalar(pData, size, set, inSet);
+
+		const NibbleTablesSSSE3 tables{ LoadNibbleTablesSSSE3(set) };
+		const unsigned flip{ inSet ? 0u : 0xFFFFu };
+		const Byte* const pEnd{ pData + size };
+
+		const Byte* p{ pData };
+		for (; pEnd - p >= 16; p += 16)
+		{
+			if (const unsigned mask{ ClassifySSSE3(p, tables) ^ flip }; mask != 0)
+				return p + std::countr_zero(mask);
+		}
+
+		if (p == pEnd)
+			return nullptr;
+
+		p = pEnd - 16;
+		const unsigned mask{ ClassifySSSE3(p, tables) ^ flip };
+
+		return mask != 0 ? p + std::countr_zero(mask) : nullptr;
+	}
+
+	struct NibbleTablesAVX2 final
+	{
+		__m256i LowHalf;
+		__m256i HighHalf;
+		__m256i Bits;
+	};
+
+	TARGET_AVX2 NibbleTablesAVX2 LoadNibbleTablesAVX2(const CharSet& set)
+	{
+		/* pshufb only shuffles within 128-bit lanes, so both lanes get a copy of the tables */
+		const CharSet::Bitmap& bitmap{ set.GetBitmap() };
+
+		return NibbleTablesAVX2
+		{
+			_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bitmap.data()))),
+			_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bitmap.data() + 16))),
+			_mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128)
+		};
+	}
+
+	TARGET_AVX2 unsigned ClassifyAVX2(const Byte* p, const NibbleTablesAVX2& tables)
+	{
+		const __m256i nibbleMask{ _mm256_set1_epi8(0x0F) };
+
+		const __m256i bytes{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) };
+		const __m256i lowNibbles{ _mm256_and_si256(bytes, nibbleMask) };
+		const __m256i highNibbles{ _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibbleMask) };
+
+		const __m256i lowHalf{ _mm256_shuffle_epi8(tables.LowHalf, lowNibbles) };
+		const __m256i highHalf{ _mm256_shuffle_epi8(tables.HighHalf, lowNibbles) };
+		const __m256i isHighHalf{ _mm256_cmpgt_epi8(highNibbles, _mm256_set1_epi8(7)) };
+		const __m256i entries{ _mm256_blendv_epi8(lowHalf, highHalf, isHighHalf) };
+
+		const __m256i bits{ _mm256_shuffle_epi8(tables.Bits, highNibbles) };
+
+		return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(entries, bits), bits)));
+	}
+
+	TARGET_AVX2 const Byte* FindAnyOfAVX2(const Byte* pData, const size_t size, const CharSet& set, const bool inSet)
+	{
+		if (size < 32)
+			return FindAnyOfSSSE3(pData, size, set, inSet);
+
+		const NibbleTablesAVX2 tables{ LoadNibbleTablesAVX2(set) };
+		const unsigned flip{ inSet ? 0u : 0xFFFFFFFFu };
+		const Byte* const pEnd{ pData + size };
+
+		const Byte* p{ pData };
+		for (; pEnd - p >= 32; p += 32)
+		{
+			if (const unsigned mask{ ClassifyAVX2(p, tables) ^ flip }; mask != 0)
+				return p + std::countr_zero(mask);
+		}
+
+		if (p == pEnd)
+			return nullptr;
+
+		p = pEnd - 32;
+		const unsigned mask{ ClassifyAVX2(p, tables) ^ flip };
+
+		return mask != 0 ? p + std::countr_zero(mask) : nullptr;
+	}
+#endif
+
+	const Byte* FindAnyOfDispatch(const Byte* pData, const size_t size, const CharSet& set, const bool inSet, const InstructionSet instructionSet)
+	{
+		assert(instructionSet <= GetInstructionSet());
+
+		switch (instructionSet)
+		{
+#ifdef STRING_SEARCH_X86
+		case InstructionSet::AVX2:
+			return FindAnyOfAVX2(pData, size, set, inSet);
+		case InstructionSet::SSSE3:
+			return FindAnyOfSSSE3(pData, size, set, inSet);
+#endif
+		default:
+			return FindAnyOfScalar(pData, size, set, inSet);
+		}
+	}
+
+#pragma endregion
+
+#pragma region Equals
+
+	uint64_t LoadWord(const Byte* p)
+	{
+		uint64_t word;
+		std::memcpy(&word, p, sizeof(word));
+
+		return word;
+	}
+
+	bool EqualsScalar(const Byte* pA, const Byte* pB, const size_t size)
+	{
+		if (size < sizeof(uint64_t))
+		{
+			for (size_t i{}; i < size; ++i)
+			{
+				if (pA[i] != pB[i])
+					return false;
+			}
+
+			return true;
+		}
+
+		/* Eight bytes at a time, the last word overlaps the one before it */
+		size_t i{};
+		for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+		{
+			if (LoadWord(pA + i) != LoadWord(pB + i))
+				return false;
+		}
+
+		return i == size || LoadWord(pA + size - sizeof(uint64_t)) == LoadWord(pB + size - sizeof(uint64_t));
+	}
+
+#ifdef STRING_SEARCH_X86
+	TARGET_SSE2 bool BlockEqualsSSE2(const Byte* pA, const Byte* pB)
+	{
+		const __m128i a{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pA)) };
+		const __m128i b{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB)) };
+
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) == 0xFFFF;
+	}
+
+	TARGET_AVX2 bool BlockEqualsAVX2(const Byte* pA, const Byte* pB)
+	{
+		const __m256i a{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pA)) };
+		const __m256i b{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pB)) };
+
+		return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b))) == 0xFFFFFFFFu;
+	}
+
+	TARGET_SSE2 bool EqualsSSE2(const Byte* pA, const Byte* pB, const size_t size)
+	{
+		if (size < 16)
+			return EqualsScalar(pA, pB, size);
+
+		size_t i{};
+		for (; i + 16 <= size; i += 16)
+		{
+			if (!BlockEqualsSSE2(pA + i, pB + i))
+				return false;
+		}
+
+		/* Finish with one overlapping compare */
+		return i == size || BlockEqualsSSE2(pA + size - 16, pB + size - 16);
+	}
+
+	TARGET_AVX2 bool EqualsAVX2(const Byte* pA, const Byte* pB, const size_t size)
+	{
+		if (size < 32)
+			return EqualsSSE2(pA, pB, size);
+
+		size_t i{};
+		for (; i + 32 <= size; i += 32)
+		{
+			if (!BlockEqualsAVX2(pA + i, pB + i))
+				return false;
+		}
+
+		return i == size || BlockEqualsAVX2(pA + size - 32, pB + size - 32);
+	}
+#endif
+
+#pragma endregion
+
+#pragma region FindMismatch
+
+	size_t FindMismatchScalar(const Byte* pA, const Byte* pB, const size_t size)
+	{
+		size_t i{};
+
+		/* The lowest differing byte of two little endian words is the first one in memory */
+		if constexpr (std::endian::native == std::endian::little)
+		{
+			for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+			{
+				if (const uint64_t difference{ LoadWord(pA + i) ^ LoadWord(pB + i) }; difference != 0)
+					return i + std::countr_zero(difference) / 8;
+			}
+		}
+
+		for (; i < size; ++i)
+		{
+			if (pA[i] != pB[i])
+				return i;
+		}
+
+		return size;
+	}
+
+#ifdef STRING_SEARCH_X86
+	TARGET_SSE2 unsigned MismatchMaskSSE2(const Byte* pA, const Byte* pB)
+	{
+		const __m128i a{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pA)) };
+		const __m128i b{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB)) };
+
+		return ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) & 0xFFFFu;
+	}
+
+	TARGET_AVX2 unsigned MismatchMaskAVX2(const Byte* pA, const Byte* pB)
+	{
+		const __m256i a{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pA)) };
+		const __m256i b{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pB)) };
+
+		return ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+	}
+
+	TARGET_SSE2 size_t FindMismatchSSE2(const Byte* pA, const Byte* pB, const size_t size)
+	{
+		if (size < 16)
+			return FindMismatchScalar(pA, pB, size);
+
+		size_t i{};
+		for (; i + 16 <= size; i += 16)
+		{
+			if (const unsigned mask{ MismatchMaskSSE2(pA + i, pB + i) }; mask != 0)
+				return i + std::countr_zero(mask);
+		}
+
+		if (i == size)
+			return size;
+
+		/* Finish with one overlapping compare, everything before i is already known to be equal */
+		i = size - 16;
+		const unsigned mask{ MismatchMaskSSE2(pA + i, pB + i) };
+
+		return mask != 0 ? i + std::countr_zero(mask) : size;
+	}
+
+	TARGET_AVX2 size_t FindMismatchAVX2(const Byte* pA, const Byte* pB, const size_t size)
+	{
+		if (size < 32)
+			return FindMismatchSSE2(pA, pB, size);
+
+		size_t i{};
+		for (; i + 32 <= size; i += 32)
+		{
+			if (const unsigned mask{ MismatchMaskAVX2(pA + i, pB + i) }; mask != 0)
+				return i + std::countr_zero(mask);
+		}
+
+		if (i == size)
+			return size;
+
+		i = size - 32;
+		const unsigned mask{ MismatchMaskAVX2(pA + i, pB + i) };
+
+		return mask != 0 ? i + std::countr_zero(mask) : size;
+	}
+#endif
+
+#pragma endregion
+
+#pragma region Case_Folding
+
+	bool EqualsIgnoreCaseScalar(const Byte* pA, const Byte* pB, const size_t size)
+	{
+		return EqualsFolded<AsciiCaseFold>(pA, pB, size);
+	}
+
+	const Byte* FindBytesIgnoreCaseTwoWay(const Byte* pHaystack, const size_t haystackSize, const Byte* pNeedle, const size_t needleSize)
+	{
+		return FindSubstringFolded<AsciiCaseFold>(pHaystack, haystackSize, pNeedle, needleSize);
+	}
+
+#ifdef STRING_SEARCH_X86
+	/* Sets bit 5 of every upper case letter. Bytes from 0x80 up are negative to the signed compares, so they are never letters */
+	TARGET_SSE2 __m128i LoadFoldedSSE2(const Byte* p)
+	{
+		const __m128i bytes{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) };
+		const __m128i isUpper{ _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(bytes, _mm_set1_epi8('Z' + 1))) };
+
+		return _mm_or_si128(bytes, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+	}
+
+	TARGET_AVX2 __m256i LoadFoldedAVX2(const Byte* p)
+	{
+		const __m256i bytes{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) };
+		const __m256i isUpper{ _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), bytes)) };
+
+		return _mm256_or_si256(bytes, _mm256_and_si256(isUpper, _mm256_set1_epi8(0x20)));
+	}
+
+	TARGET_SSE2 bool BlockEqualsIgnoreCaseSSE2(const Byte* pA, const Byte* pB)
+	{
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(LoadFoldedSSE2(pA), LoadFoldedSSE2(pB))) == 0xFFFF;
+	}
+
+	TARGET_AVX2 bool BlockEqualsIgnoreCaseAVX2(const Byte* pA, const Byte* pB)
+	{
+		return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(LoadFoldedAVX2(pA), LoadFoldedAVX2(pB)))) == 0xFFFFFFFFu;
+	}
+
+	TARGET_SSE2 bool EqualsIgnoreCaseSSE2(const Byte* pA, const Byte* pB, const size_t size)
+	{
+		if (size < 16)
+			return EqualsIgnoreCaseScalar(pA, pB, size);
+
+		size_t i{};
+		for (; i + 16 <= size; i += 16)
+		{
+			if (!BlockEqualsIgnoreCaseSSE2(pA + i, pB + i))
+				return false;
+		}
+
+		/* Finish with one overlapping compare */
+		return i == size || BlockEqualsIgnoreCaseSSE2(pA + size - 16, pB + size - 16);
+	}
+
+	TARGET_AVX2 bool EqualsIgnoreCaseAVX2(const Byte* pA, const Byte* pB, const size_t size)
+	{
+		if (size < 32)
+			return EqualsIgnoreCaseSSE2(pA, pB, size);
+
+		size_t i{};
+		for (; i + 32 <= size; i += 32)
+		{
+			if (!BlockEqualsIgnoreCaseAVX2(pA + i, pB + i))
+				return false;
+		}
+
+		return i == size || BlockEqualsIgnoreCaseAVX2(pA + size - 32, pB + size - 32);
+	}
+
+	TARGET_SSE2 const Byte* FindBytesIgnoreCaseSSE2(const Byte* pHaystack, const size_t haystackSize, const Byte* pNeedle, const size_t needleSize)
+	{
+		assert(needleSize >= 1);
+
+		const __m128i first{ _mm_set1_epi8(static_cast<char>(AsciiCaseFold::Fold(pNeedle[0]))) };
+		const __m128i last{ _mm_set1_epi8(static_cast<char>(AsciiCaseFold::Fold(pNeedle[needleSize - 1]))) };
+
+		size_t verifiedBytes{};
+		size_t i{};
+
+		while (i + needleSize - 1 + 16 <= haystackSize)
+		{
+			const __m128i firstBlock{ LoadFoldedSSE2(pHaystack + i) };
+			const __m128i lastBlock{ LoadFoldedSSE2(pHaystack + i + needleSize - 1) };
+
+			unsigned mask{ static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(firstBlock, first), _mm_cmpeq_epi8(lastBlock, last)))) };
+
+			while (mask != 0)
+			{
+				const size_t position{ i + std::countr_zero(mask) };
+
+				if (needleSize <= 2 || EqualsIgnoreCaseSSE2(pHaystack + position + 1, pNeedle + 1, needleSize - 2))
+					return pHaystack + position;
+
+				verifiedBytes += needleSize;
+				mask &= mask - 1;
+			}
+
+			/* Like FindBytes, the fallback picks up after this block */
+			i += 16;
+
+			if (IsVerificationTooExpensive(verifiedBytes, i))
+				break;
+		}
+
+		return FindBytesIgnoreCaseTwoWay(pHaystack + i, haystackSize - i, pNeedle, needleSize);
+	}
+
+	TARGET_AVX2 const Byte* FindBytesIgnoreCaseAVX2(const Byte* pHaystack, const size_t haystackSize, const Byte* pNeedle, const size_t needleSize)
+	{
+		assert(needleSize >= 1);
+
+		const __m256i first{ _mm256_set1_epi8(static_cast<char>(AsciiCaseFold::Fold(pNeedle[0]))) };
+		const __m256i last{ _mm256_set1_epi8(static_cast<char>(AsciiCaseFold::Fold(pNeedle[needleSize - 1]))) };
+
+		size_t verifiedBytes{};
+		size_t i{};
+
+		while (i + needleSize - 1 + 32 <= haystackSize)
+		{
+			const __m256i firstBlock{ LoadFoldedAVX2(pHaystack + i) };
+			const __m256i lastBlock{ LoadFoldedAVX2(pHaystack + i + needleSize - 1) };
+
+			unsigned mask{ static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(firstBlock, first), _mm256_cmpeq_epi8(lastBlock, last)))) };
+
+			while (mask != 0)
+			{
+				const size_t position{ i + std::countr_zero(mask) };
+
+				if (needleSize <= 2 || EqualsIgnoreCaseAVX2(pHaystack + position + 1, pNeedle + 1, needleSize - 2))
+					return pHaystack + position;
+
+				verifiedBytes += needleSize;
+				mask &= mask - 1;
+			}
+
+			i += 32;
+
+			if (IsVerificationTooExpensive(verifiedBytes, i))
+				break;
+		}
+
+		return FindBytesIgnoreCaseTwoWay(pHaystack + i, haystackSize - i, pNeedle, needleSize);
+	}
+#endif
+
+#pragma endregion
+}
+
+namespace StringSearch
+{
+	InstructionSet GetInstructionSet()
+	{
+		static const InstructionSet instructionSet{ DetectInstructionSet() };
+
+		return instructionSet;
+	}
+
+	const void* FindByte(const void* pData, const size_t size, const unsigned char value)
+	{
+		if (size < MinVectorSize)
+			return FindByteScalar(static_cast<const Byte*>(pData), size, value);
+
+		return FindByte(pData, size, value, GetInstructionSet());
+	}
+
+	const void* FindByte(const void* pData, const size_t size, const unsigned char value, const InstructionSet set)
+	{
+		assert(set <= GetInstructionSet());
+
+		const Byte* pBytes{ static_cast<const Byte*>(pData) };
+
+		switch (set)
+		{
+#ifdef STRING_SEARCH_X86
+		case InstructionSet::AVX2:
+			return FindByteAVX2(pBytes, size, value);
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			return FindByteSSE2(pBytes, size, value);
+#endif
+		default:
+			return FindByteScalar(pBytes, size, value);
+		}
+	}
+
+	const void* FindBytes(const void* pHaystack, const size_t haystackSize, const void* pNeedle, const size_t needleSize)
+	{
+		if (haystackSize < MinVectorSubstringSize)
+			return FindBytes(pHaystack, haystackSize, pNeedle, needleSize, InstructionSet::Scalar);
+
+		return FindBytes(pHaystack, haystackSize, pNeedle, needleSize, GetInstructionSet());
+	}
+
+	const void* FindBytes(const void* pHaystack, const size_t haystackSize, const void* pNeedle, const size_t needleSize, const InstructionSet set)
+	{
+		assert(set <= GetInstructionSet());
+
+		const Byte* pHaystackBytes{ static_cast<const Byte*>(pHaystack) };
+		const Byte* pNeedleBytes{ static_cast<const Byte*>(pNeedle) };
+
+		if (needleSize == 1)
+			return FindByte(pHaystack, haystackSize, pNeedleBytes[0], set);
+
+		if (needleSize == 0 || needleSize > haystackSize)
+			return FindBytesTwoWay(pHaystackBytes, haystackSize, pNeedleBytes, needleSize);
+
+		switch (set)
+		{
+#ifdef STRING_SEARCH_X86
+		case InstructionSet::AVX2:
+			return FindBytesAVX2(pHaystackBytes, haystackSize, pNeedleBytes, needleSize);
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			return FindBytesSSE2(pHaystackBytes, haystackSize, pNeedleBytes, needleSize);
+#endif
+		default:
+			return FindBytesTwoWay(pHaystackBytes, haystackSize, pNeedleBytes, needleSize);
+		}
+	}
+
+	const void* FindLastByte(const void* pData, const size_t size, const unsigned char value)
+	{
+		if (size < MinVectorSize)
+			return FindLastByteScalar(static_cast<const Byte*>(pData), size, value);
+
+		return FindLastByte(pData, size, value, GetInstructionSet());
+	}
+
+	const void* FindLastByte(const void* pData, const size_t size, const unsigned char value, const InstructionSet set)
+	{
+		assert(set <= GetInstructionSet());
+
+		const Byte* pBytes{ static_cast<const Byte*>(pData) };
+
+		switch (set)
+		{
+#ifdef STRING_SEARCH_X86
+		case InstructionSet::AVX2:
+			return FindLastByteAVX2(pBytes, size, value);
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			return FindLastByteSSE2(pBytes, size, value);
+#endif
+		default:
+			return FindLastByteScalar(pBytes, size, value);
+		}
+	}
+
+	const void* FindLastBytes(const void* pHaystack, const size_t haystackSize, const void* pNeedle, const size_t needleSize)
+	{
+		if (haystackSize < MinVectorSubstringSize)
+			return FindLastBytes(pHaystack, haystackSize, pNeedle, needleSize, InstructionSet::Scalar);
+
+		return FindLastBytes(pHaystack, haystackSize, pNeedle, needleSize, GetInstructionSet());
+	}
+
+	const void* FindLastBytes(const void* pHaystack, const size_t haystackSize, const void* pNeedle, const size_t needleSize, const InstructionSet set)
+	{
+		assert(set <= GetInstructionSet());
+
+		const Byte* pHaystackBytes{ static_cast<const Byte*>(pHaystack) };
+		const Byte* pNeedleBytes{ static_cast<const Byte*>(pNeedle) };
+
+		if (needleSize == 1)
+			return FindLastByte(pHaystack, haystackSize, pNeedleBytes[0], set);
+
+		if (needleSize == 0 || needleSize > haystackSize)
+			return FindLastBytesTwoWay(pHaystackBytes, haystackSize, pNeedleBytes, needleSize);
+
+		switch (set)
+		{
+#ifdef STRING_SEARCH_X86
+		case InstructionSet::AVX2:
+			return FindLastBytesAVX2(pHaystackBytes, haystackSize, pNeedleBytes, needleSize);
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			return FindLastBytesSSE2(pHaystackBytes, haystackSize, pNeedleBytes, needleSize);
+#endif
+		default:
+			return FindLastBytesTwoWay(pHaystackBytes, haystackSize, pNeedleBytes, needleSize);
+		}
+	}
+
+	const void* FindAnyOf(const void* pData, const size_t size, const CharSet& set)
+	{
+		const InstructionSet instructionSet{ size < MinVectorSize ? InstructionSet::Scalar : GetInstructionSet() };
+
+		return FindAnyOfDispatch(static_cast<const Byte*>(pData), size, set, true, instructionSet);
+	}
+
+	const void* FindAnyOf(const void* pData, const size_t size, const CharSet& set, const InstructionSet instructionSet)
+	{
+		return FindAnyOfDispatch(static_cast<const Byte*>(pData), size, set, true, instructionSet);
+	}
+
+	const void* FindNoneOf(const void* pData, const size_t size, const CharSet& set)
+	{
+		const InstructionSet instructionSet{ size < MinVectorSize ? InstructionSet::Scalar : GetInstructionSet() };
+
+		return FindAnyOfDispatch(static_cast<const Byte*>(pData), size, set, false, instructionSet);
+	}
+
+	const void* FindNoneOf(const void* pData, const size_t size, const CharSet& set, const InstructionSet instructionSet)
+	{
+		return FindAnyOfDispatch(static_cast<const Byte*>(pData), size, set, false, instructionSet);
+	}
+
+	bool EqualsIgnoreCase(const void* pA, const void* pB, const size_t size)
+	{
+		if (size < MinVectorSize)
+			return EqualsIgnoreCaseScalar(static_cast<const Byte*>(pA), static_cast<const Byte*>(pB), size);
+
+		return EqualsIgnoreCase(pA, pB, size, GetInstructionSet());
+	}
+
+	bool EqualsIgnoreCase(const void* pA, const void* pB, const size_t size, const InstructionSet set)
+	{
+		assert(set <= GetInstructionSet());
+
+		const Byte* pBytesA{ static_cast<const Byte*>(pA) };
+		const Byte* pBytesB{ static_cast<const Byte*>(pB) };
+
+		switch (set)
+		{
+#ifdef STRING_SEARCH_X86
+		case InstructionSet::AVX2:
+			return EqualsIgnoreCaseAVX2(pBytesA, pBytesB, size);
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			return EqualsIgnoreCaseSSE2(pBytesA, pBytesB, size);
+#endif
+		default:
+			return EqualsIgnoreCaseScalar(pBytesA, pBytesB, size);
+		}
+	}
+
+	const void* FindBytesIgnoreCase(const void* pHaystack, const size_t haystackSize, const void* pNeedle, const size_t needleSize)
+	{
+		if (haystackSize < MinVectorSubstringSize)
+			return FindBytesIgnoreCase(pHaystack, haystackSize, pNeedle, needleSize, InstructionSet::Scalar);
+
+		return FindBytesIgnoreCase(pHaystack, haystackSize, pNeedle, needleSize, GetInstructionSet());
+	}
+
+	const void* FindBytesIgnoreCase(const void* pHaystack, const size_t haystackSize, const void* pNeedle, const size_t needleSize, const InstructionSet set)
+	{
+		assert(set <= GetInstructionSet());
+
+		const Byte* pHaystackBytes{ static_cast<const Byte*>(pHaystack) };
+		const Byte* pNeedleBytes{ static_cast<const Byte*>(pNeedle) };
+
+		if (needleSize == 0 || needleSize > haystackSize)
+			return FindBytesIgnoreCaseTwoWay(pHaystackBytes, haystackSize, pNeedleBytes, needleSize);
+
+		switch (set)
+		{
+#ifdef STRING_SEARCH_X86
+		case InstructionSet::AVX2:
+			return FindBytesIgnoreCaseAVX2(pHaystackBytes, haystackSize, pNeedleBytes, needleSize);
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			return FindBytesIgnoreCaseSSE2(pHaystackBytes, haystackSize, pNeedleBytes, needleSize);
+#endif
+		default:
+			return FindBytesIgnoreCaseTwoWay(pHaystackBytes, haystackSize, pNeedleBytes, needleSize);
+		}
+	}
+
+	bool Equals(const void* pA, const void* pB, const size_t size)
+	{
+		if (size < MinVectorSize)
+			return EqualsScalar(static_cast<const Byte*>(pA), static_cast<const Byte*>(pB), size);
+
+		return Equals(pA, pB, size, GetInstructionSet());
+	}
+
+	bool Equals(const void* pA, const void* pB, const size_t size, const InstructionSet set)
+	{
+		assert(set <= GetInstructionSet());
+
+		const Byte* pBytesA{ static_cast<const Byte*>(pA) };
+		const Byte* pBytesB{ static_cast<const Byte*>(pB) };
+
+		switch (set)
+		{
+#ifdef STRING_SEARCH_X86
+		case InstructionSet::AVX2:
+			return EqualsAVX2(pBytesA, pBytesB, size);
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			return EqualsSSE2(pBytesA, pBytesB, size);
+#endif
+		default:
+			return EqualsScalar(pBytesA, pBytesB, size);
+		}
+	}
+
+	size_t FindMismatch(const void* pA, const void* pB, const size_t size)
+	{
+		if (size < MinVectorSize)
+			return FindMismatchScalar(static_cast<const Byte*>(pA), static_cast<const Byte*>(pB), size);
+
+		return FindMismatch(pA, pB, size, GetInstructionSet());
+	}
+
+	size_t FindMismatch(const void* pA, const void* pB, const size_t size, const InstructionSet set)
+	{
+		assert(set <= GetInstructionSet());
+
+		const Byte* pBytesA{ static_cast<const Byte*>(pA) };
+		const Byte* pBytesB{ static_cast<const Byte*>(pB) };
+
+		switch (set)
+		{
+#ifdef STRING_SEARCH_X86
+		case InstructionSet::AVX2:
+			return FindMismatchAVX2(pBytesA, pBytesB, size);
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			return FindMismatchSSE2(pBytesA, pBytesB, size);
+#endif
+		default:
+			return FindMismatchScalar(pBytesA, pBytesB, size);
+		}
+	}
+}
@@ -0,0 +1,333 @@
+#pragma once
+
+#include "CharSet.h"
+
+#include <cstddef> /* size_t */
+#include <algorithm> /* std::max(), std::equal() */
+#include <iterator> /* std::make_reverse_iterator(), std::forward_iterator_tag */
+
+#ifndef NODISCARD
+#define NODISCARD [[nodiscard]]
+#endif
+
+/* Search algorithms used by CustomString.
+   The byte kernels have a scalar, SSE2 and AVX2 version, the best one the CPU supports is picked at runtime.
+   Kernels that need pshufb use SSSE3 instead of SSE2, the other kernels treat SSSE3 as SSE2.
+   They are only used for single-byte character types, the templates work for any character type. */
+namespace StringSearch
+{
+	enum class InstructionSet
+	{
+		Scalar,
+		SSE2,
+		SSSE3,
+		AVX2
+	};
+
+	/* Best instruction set supported by both the CPU and the OS, detected once */
+	NODISCARD InstructionSet GetInstructionSet();
+
+	/* Returns a pointer to the first byte in [pData, pData + size) equal to value, or nullptr */
+	NODISCARD const void* FindByte(const void* pData, const size_t size, const unsigned char value);
+	NODISCARD const void* FindByte(const void* pData, const size_t size, const unsigned char value, const InstructionSet set);
+
+	/* Haystacks shorter than this are searched with FindSubstring() straight away */
+	constexpr size_t MinVectorSubstringSize{ 64 };
+
+	/* Returns a pointer to the first occurrence of the needle bytes in the haystack bytes, or nullptr.
+	   Positions where both the first and the last needle byte match are found with SIMD compares and then verified.
+	   When too many of those candidates turn out to be false, the rest of the haystack is searched with FindSubstring() */
+	NODISCARD const void* FindBytes(const void* pHaystack, const size_t haystackSize, const void* pNeedle, const size_t needleSize);
+	NODISCARD const void* FindBytes(const void* pHaystack, const size_t haystackSize, const void* pNeedle, const size_t needleSize, const InstructionSet set);
+
+	/* Two-Way string matching (Crochemore-Perrin): linear time in haystackSize + needleSize and constant extra space.
+	   Returns a pointer to the first occurrence of the needle in the haystack, or nullptr */
+	template<typename T>
+	NODISCARD const T* FindSubstring(const T* pHaystack, const size_t haystackSize, const T* pNeedle, const size_t needleSize);
+
+	/* Returns a pointer to the last byte in [pData, pData + size) equal to value, or nullptr */
+	NODISCARD const void* FindLastByte(const void* pData, const size_t size, const unsigned char value);
+	NODISCARD const void* FindLastByte(const void* pData, const size_t size, const unsigned char value, const InstructionSet set);
+
+	/* The backwards counterpart of FindBytes(): the same SIMD filter, walking blocks from the end of the haystack */
+	NODISCARD const void* FindLastBytes(const void* pHaystack, const size_t haystackSize, const void* pNeedle, const size_t needleSize);
+	NODISCARD const void* FindLastBytes(const void* pHaystack, const size_t haystackSize, const void* pNeedle, const size_t needleSize, const InstructionSet set);
+
+	/* Two-Way on the reversed haystack and needle. Returns a pointer to the last occurrence of the needle, or nullptr */
+	template<typename T>
+	NODISCARD const T* FindLastSubstring(const T* pHaystack, const size_t haystackSize, const T* pNeedle, const size_t needleSize);
+
+	/* Returns a pointer to the first byte in [pData, pData + size) that is in the set, or nullptr.
+	   Every byte is classified with a nibble lookup (pshufb), 16 or 32 bytes at a time */
+	NODISCARD const void* FindAnyOf(const void* pData, const size_t size, const CharSet& set);
+	NODISCARD const void* FindAnyOf(const void* pData, const size_t size, const CharSet& set, const InstructionSet instructionSet);
+
+	/* Returns a pointer to the first byte in [pData, pData + size) that is not in the set, or nullptr */
+	NODISCARD const void* FindNoneOf(const void* pData, const size_t size, const CharSet& set);
+	NODISCARD const void* FindNoneOf(const void* pData, const size_t size, const CharSet& set, const InstructionSet instructionSet);
+
+	/* Returns whether the first size bytes of both buffers are equal */
+	NODISCARD bool Equals(const void* pA, const void* pB, const size_t size);
+	NODISCARD bool Equals(const void* pA, const void* pB, const size_t size, const InstructionSet set);
+
+	/* Returns the index of the first byte that differs between both buffers, or size if they are equal */
+	NODISCARD size_t FindMismatch(const void* pA, const void* pB, const size_t size);
+	NODISCARD size_t FindMismatch(const void* pA, const void* pB, const size_t size, const InstructionSet set);
+
+	/* Maps 'A'-'Z' to 'a'-'z' and leaves every other character alone.
+	   The case-insensitive functions take their fold as a template parameter: any type with a static Fold(T) will do,
+	   e.g. one that looks characters up in a Unicode case folding table. Only this fold has SIMD kernels */
+	struct AsciiCaseFold final
+	{
+		template<typename T>
+		NODISCARD constexpr static T Fold(const T c)
+		{
+			return (c >= T('A') && c <= T('Z')) ? static_cast<T>(c + ('a' - 'A')) : c;
+		}
+	};
+
+	/* Returns whether the first size bytes of both buffers are equal once ASCII letters are folded */
+	NODISCARD bool EqualsIgnoreCase(const void* pA, const void* pB, const size_t size);
+	NODISCARD bool EqualsIgnoreCase(const void* pA, const void* pB, const size_t size, const InstructionSet set);
+
+	/* FindBytes() with ASCII letters folded: the first and last needle byte filter compares folded blocks,
+	   candidates are verified with EqualsIgnoreCase() and the fallback is FindSubstringFolded() */
+	NODISCARD const void* FindBytesIgnoreCase(const void* pHaystack, const size_t haystackSize, const void* pNeedle, const size_t needleSize);
+	NODISCARD const void* FindBytesIgnoreCase(const void* pHaystack, const size_t haystackSize, const void* pNeedle, const size_t needleSize, const InstructionSet set);
+
+	template<typename Fold, typename T>
+	NODISCARD bool EqualsFolded(const T* pA, const T* pB, const size_t size);
+
+	/* Two-Way over the folded characters of both the haystack and the needle */
+	template<typename Fold, typename T>
+	NODISCARD const T* FindSubstringFolded(const T* pHaystack, const size_t haystackSize, const T* pNeedle, const size_t needleSize);
+
+	namespace Detail
+	{
+		constexpr size_t NoMatch{ static_cast<size_t>(-1) };
+
+		/* It is either a plain pointer or a reverse iterator, which is how the backwards search reuses the algorithm */
+		template<typename It>
+		NODISCARD size_t MaximalSuffix(const It pNeedle, const size_t needleSize, size_t& period, const bool reversed);
+		template<typename It>
+		NODISCARD size_t TwoWay(const It pHaystack, const size_t haystackSize, const It pNeedle, const size_t needleSize);
+
+		/* Reads characters through Fold, which lets TwoWay() search folded text without copying it */
+		template<typename Fold, typename T>
+		class FoldingIterator final
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = T;
+
+			constexpr FoldingIterator() = default;
+			constexpr explicit FoldingIterator(const T* p)
+				: m_p{ p }
+			{}
+
+			NODISCARD constexpr T operator*() const { return Fold::Fold(*m_p); }
+			NODISCARD constexpr T operator[](const size_t index) const { return Fold::Fold(m_p[index]); }
+			NODISCARD constexpr FoldingIterator operator+(const size_t offset) const { return FoldingIterator{ m_p + offset }; }
+
+			constexpr FoldingIterator& operator++()
+			{
+				++m_p;
+				return *this;
+			}
+
+			constexpr FoldingIterator operator++(int)
+			{
+				FoldingIterator copy{ *this };
+				++m_p;
+				return copy;
+			}
+
+			NODISCARD constexpr bool operator==(const FoldingIterator& other) const { return m_p == other.m_p; }
+
+		private:
+			const T* m_p{};
+		};
+	}
+}
+
+#pragma region Two_Way
+
+template<typename It>
+size_t StringSearch::Detail::MaximalSuffix(const It pNeedle, const size_t needleSize, size_t& period, const bool reversed)
+{
+	/* Start of the maximal suffix for the regular or the reversed ordering, minus one.
+	   The indices rely on unsigned wrap-around: -1 is used as "before the start" */
+	size_t maxSuffix{ static_cast<size_t>(-1) };
+	size_t j{};
+	size_t k{ 1 };
+	period = 1;
+
+	while (j + k < needleSize)
+	{
+		const auto a{ pNeedle[j + k] };
+		const auto b{ pNeedle[maxSuffix + k] };
+
+		if (reversed ? b < a : a < b)
+		{
+			/* The suffix is smaller, so the period is the entire prefix so far */
+			j += k;
+			k = 1;
+			period = j - maxSuffix;
+		}
+		else if (a == b)
+		{
+			/* Advance through a repetition of the current period */
+			if (k != period)
+			{
+				++k;
+			}
+			else
+			{
+				j += period;
+				k = 1;
+			}
+		}
+		else
+		{
+			/* The suffix is larger, start over from here */
+			maxSuffix = j++;
+			k = period = 1;
+		}
+	}
+
+	return maxSuffix;
+}
+
+template<typename It>
+size_t StringSearch::Detail::TwoWay(const It pHaystack, const size_t haystackSize, const It pNeedle, const size_t needleSize)
+{
+	if (needleSize == 0)
+		return 0;
+
+	if (needleSize > haystackSize)
+		return NoMatch;
+
+	/* Critical factorization: the larger of the two maximal suffixes splits the needle into a left and right half */
+	size_t period{};
+	size_t reversedPeriod{};
+	const size_t maxSuffix{ MaximalSuffix(pNeedle, needleSize, period, false) };
+	const size_t reversedMaxSuffix{ MaximalSuffix(pNeedle, needleSize, reversedPeriod, true) };
+
+	size_t suffix{ maxSuffix + 1 };
+	if (reversedMaxSuffix + 1 > maxSuffix + 1)
+	{
+		suffix = reversedMaxSuffix + 1;
+		period = reversedPeriod;
+	}
+
+	/* Candidate positions stop where the needle no longer fits */
+	const size_t lastPosition{ haystackSize - needleSize };
+
+	if (suffix <= needleSize - period && std::equal(pNeedle, pNeedle + suffix, pNeedle + period))
+	{
+		/* The needle is periodic, remember how much of the left half is known to match after a shift by the period */
+		size_t memory{};
+
+		for (size_t j{}; j <= lastPosition;)
+		{
+			size_t i{ std::max(suffix, memory) };
+			while (i < needleSize && pNeedle[i] == pHaystack[i + j])
+				++i;
+
+			if (i < needleSize)
+			{
+				j += i - suffix + 1;
+				memory = 0;
+				continue;
+			}
+
+			i = suffix;
+			while (i > memory && pNeedle[i - 1] == pHaystack[i - 1 + j])
+				--i;
+
+			if (i <= memory)
+				return j;
+
+			j += period;
+			memory = needleSize - period;
+		}
+	}
+	else
+	{
+		/* The halves can not overlap with themselves, so every mismatch allows a large shift */
+		period = std::max(suffix, needleSize - suffix) + 1;
+
+		for (size_t j{}; j <= lastPosition;)
+		{
+			size_t i{ suffix };
+			while (i < needleSize && pNeedle[i] == pHaystack[i + j])
+				++i;
+
+			if (i < needleSize)
+			{
+				j += i - suffix + 1;
+				continue;
+			}
+
+			i = suffix;
+			while (i > 0 && pNeedle[i - 1] == pHaystack[i - 1 + j])
+				--i;
+
+			if (i == 0)
+				return j;
+
+			j += period;
+		}
+	}
+
+	return NoMatch;
+}
+
+template<typename T>
+const T* StringSearch::FindSubstring(const T* pHaystack, const size_t haystackSize, const T* pNeedle, const size_t needleSize)
+{
+	const size_t index{ Detail::TwoWay(pHaystack, haystackSize, pNeedle, needleSize) };
+
+	return index != Detail::NoMatch ? pHaystack + index : nullptr;
+}
+
+template<typename T>
+const T* StringSearch::FindLastSubstring(const T* pHaystack, const size_t haystackSize, const T* pNeedle, const size_t needleSize)
+{
+	/* The first match in the reversed haystack is the last one in the original */
+	const size_t index{ Detail::TwoWay(std::make_reverse_iterator(pHaystack + haystackSize), haystackSize,
+		std::make_reverse_iterator(pNeedle + needleSize), needleSize) };
+
+	return index != Detail::NoMatch ? pHaystack + (haystackSize - index - needleSize) : nullptr;
+}
+
+#pragma endregion
+
+#pragma region Case_Folding
+
+template<typename Fold, typename T>
+bool StringSearch::EqualsFolded(const T* pA, const T* pB, const size_t size)
+{
+	for (size_t i{}; i < size; ++i)
+	{
+		if (Fold::Fold(pA[i]) != Fold::Fold(pB[i]))
+			return false;
+	}
+
+	return true;
+}
+
+template<typename Fold, typename T>
+const T* StringSearch::FindSubstringFolded(const T* pHaystack, const size_t haystackSize, const T* pNeedle, const size_t needleSize)
+{
+	using Iterator = Detail::FoldingIterator<Fold, T>;
+
+	const size_t index{ Detail::TwoWay(Iterator{ pHaystack }, haystackSize, Iterator{ pNeedle }, needleSize) };
+
+	return index != Detail::NoMatch ? pHaystack + index : nullptr;
+}
+
+#pragma endregion
@@ -1,16 +1,77 @@
 #define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "catch.hpp"
 #include "CustomString/CustomString.h"
+#include "CustomString/StringArena.h"
+#include "CustomString/BufferPool.h"
+#include "CustomString/CowString.h"
+#include "CustomString/SharedString.h"
+#include "CustomString/StringInterner.h"
+#include "CustomString/PatternMatcher.h"
+#include "CustomString/Searcher.h"
+#include "CustomString/ApproxSearcher.h"
+#include "CustomString/CharSet.h"
+#include "CustomString/StringLookup.h"
 #include <vld.h>
 #include <limits>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+#include <string>
+#include <memory>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <string_view>
+#include <atomic>
 
 using String = CustomString<char>;
 
+template<typename String>
 bool IsStringNullTerminated(const String& str)
 {
 	return *(str.Data() + str.Size()) == '\0';
 }
 
+template<typename String>
+concept CanFindAllInTemporary = requires(const String& str) { str.FindAll(String{ "ab" }); };
+
+struct AllocationStats final
+{
+	size_t NrOfAllocations{};
+	size_t NrOfDeallocations{};
+};
+
+template<typename T, bool Propagate>
+struct CountingAllocator final
+{
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+	using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+	using propagate_on_container_swap = std::bool_constant<Propagate>;
+
+	explicit CountingAllocator(AllocationStats* pStats)
+		: pStats{ pStats }
+	{}
+
+	T* allocate(const size_t n)
+	{
+		++pStats->NrOfAllocations;
+		return std::allocator<T>{}.allocate(n);
+	}
+
+	void deallocate(T* p, const size_t n)
+	{
+		++pStats->NrOfDeallocations;
+		std::allocator<T>{}.deallocate(p, n);
+	}
+
+	bool operator==(const CountingAllocator& other) const { return pStats == other.pStats; }
+
+	AllocationStats* pStats;
+};
+
 TEST_CASE("Test Custom String")
 {
 	SECTION("Test default ctor")
@@ -19,7 +80,7 @@ TEST_CASE("Test Custom String")
 
 		REQUIRE(string.Size() == 0);
 		REQUIRE(string.Capacity() == 0);
-		REQUIRE(string.MaxSize() == std::numeric_limits<size_t>::max());
+		REQUIRE(string.MaxSize() == std::numeric_limits<size_t>::max() / 2);
 		REQUIRE(string.Data() == nullptr);
 	}
 
@@ -29,7 +90,7 @@ TEST_CASE("Test Custom String")
 
 		REQUIRE(string.Size() == 7);
 		REQUIRE(string.Capacity() >= 7);
-		REQUIRE(string.MaxSize() == std::numeric_limits<size_t>::max());
+		REQUIRE(string.MaxSize() == std::numeric_limits<size_t>::max() / 2);
 		REQUIRE(string.Data() != nullptr);
 		REQUIRE(string == "LLLLLLL");
 		REQUIRE(string[0] == 'L');
@@ -43,7 +104,7 @@ TEST_CASE("Test Custom String")
 
 		REQUIRE(str.Size() == 12);
 		REQUIRE(str.Capacity() >= 12);
-		REQUIRE(str.MaxSize() == std::numeric_limits<size_t>::max());
+		REQUIRE(str.MaxSize() == std::numeric_limits<size_t>::max() / 2);
 		REQUIRE(str.Data() != nullptr);
 		REQUIRE(IsStringNullTerminated(str));
 	}
@@ -96,7 +157,7 @@ TEST_CASE("Test Custom String")
 
 		REQUIRE(string.Size() == 12);
 		REQUIRE(string.Capacity() >= 12);
-		REQUIRE(string.MaxSize() == std::numeric_limits<size_t>::max());
+		REQUIRE(string.MaxSize() == std::numeric_limits<size_t>::max() / 2);
 		REQUIRE(string.Data() != str.Data());
 		REQUIRE(string == "Hello World!");
 		REQUIRE(IsStringNullTerminated(string));
@@ -113,7 +174,7 @@ TEST_CASE("Test Custom String")
 
 		REQUIRE(string.Size() == 12);
 		REQUIRE(string.Capacity() >= 12);
-		REQUIRE(string.MaxSize() == std::numeric_limits<size_t>::max());
+		REQUIRE(string.MaxSize() == std::numeric_limits<size_t>::max() / 2);
 		REQUIRE(string.Data() != str.Data());
 		REQUIRE(string == "Hello World!");
 		REQUIRE(IsStringNullTerminated(string));
@@ -127,7 +188,7 @@ TEST_CASE("Test Custom String")
 
 		REQUIRE(string2.Size() == 12);
 		REQUIRE(string2.Capacity() >= 12);
-		REQUIRE(string2.MaxSize() == std::numeric_limits<size_t>::max());
+		REQUIRE(string2.MaxSize() == std::numeric_limits<size_t>::max() / 2);
 		REQUIRE(string2.Data() != str.Data());
 		REQUIRE(string2 == "Hello World!");
 		REQUIRE(IsStringNullTerminated(string2));
@@ -166,6 +227,304 @@ TEST_CASE("Test Custom String")
 		REQUIRE(string2 != string);
 	}
 
+	SECTION("Ordering")
+	{
+		const String apple{ "apple" };
+		const String apples{ "apples" };
+		const String banana{ "banana" };
+
+		REQUIRE(apple < apples);
+		REQUIRE(apples < banana);
+		REQUIRE(banana > apple);
+		REQUIRE(apple <= String{ "apple" });
+		REQUIRE((apple <=> String{ "apple" }) == std::strong_ordering::equal);
+		REQUIRE(String{} < apple);
+		REQUIRE(!(String{} < String{}));
+
+		REQUIRE(apple < "apples");
+		REQUIRE(apple > "app");
+		REQUIRE(apple >= "apple");
+		REQUIRE("banana" > apple);
+		REQUIRE((String{} <=> "") == std::strong_ordering::equal);
+		REQUIRE(String{} < "a");
+
+		/* Characters compare as unsigned code units, like memcmp() */
+		REQUIRE(String{ "\xE9" } > String{ "z" });
+		REQUIRE(String{ "\xE9" } > "z");
+
+		/* A null is smaller than any other character and a C string ends at its first one */
+		String withNull{};
+		withNull.Assign("ab\0c", 4);
+		REQUIRE(withNull > String{ "ab" });
+		REQUIRE(withNull < String{ "abc" });
+		REQUIRE(withNull > "ab");
+
+		/* Long strings that only differ in their last character */
+		String longA{ 'x', 1000 };
+		String longB{ longA };
+		longB[999] = 'y';
+		REQUIRE(longA < longB);
+		REQUIRE(longB > longA);
+
+		std::vector<String> fruits{ banana, apples, String{ "cherry" }, apple };
+		std::sort(fruits.begin(), fruits.end());
+		REQUIRE(fruits == std::vector<String>{ apple, apples, banana, String{ "cherry" } });
+
+		std::map<String, int> prices{};
+		prices[banana] = 2;
+		prices[apple] = 1;
+		REQUIRE(prices.begin()->first == apple);
+		REQUIRE(std::binary_search(fruits.begin(), fruits.end(), String{ "banana" }));
+
+		const CustomString<wchar_t> wideA{ L"\u00e9" };
+		const CustomString<wchar_t> wideB{ L"\u0100" };
+		REQUIRE(wideA < wideB);
+		REQUIRE(wideB > L"\u00ff");
+	}
+
+	SECTION("Hashing")
+	{
+		const String str{ "The quick brown fox jumps over the lazy dog" };
+
+		REQUIRE(str.Hash() == String{ str }.Hash());
+		REQUIRE(str.Hash() == pmr::CustomString<char>{ "The quick brown fox jumps over the lazy dog" }.Hash());
+		REQUIRE(str.Hash() != String{ "The quick brown fox jumps over the lazy cog" }.Hash());
+		REQUIRE(str.Hash(1) != str.Hash(2));
+		REQUIRE(str.Hash(StringHash::RandomSeed()) == str.Hash(StringHash::RandomSeed()));
+		REQUIRE(std::hash<String>{}(str) == str.Hash());
+
+		REQUIRE(String{}.Hash() != String{ '\0', 1 }.Hash());
+		REQUIRE(String{ '\0', 1 }.Hash() != String{ '\0', 2 }.Hash());
+
+		/* Every prefix and every single byte change of a random string hashes differently, across all the short and long input paths */
+		uint32_t seed{ 99 };
+		String bytes{ 'a', 300 };
+		for (size_t i{}; i < bytes.Size(); ++i)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			bytes[i] = static_cast<char>((seed >> 24) | 1);
+		}
+
+		std::unordered_set<size_t> hashes{};
+		size_t nrOfStrings{};
+		for (size_t size{}; size <= bytes.Size(); ++size)
+		{
+			String prefix{};
+			prefix.Assign(bytes.Data(), size);
+
+			hashes.insert(prefix.Hash());
+			++nrOfStrings;
+
+			for (size_t i{}; i < size; ++i)
+			{
+				prefix[i] ^= 1;
+				hashes.insert(prefix.Hash());
+				prefix[i] ^= 1;
+				++nrOfStrings;
+			}
+		}
+		REQUIRE(hashes.size() == nrOfStrings);
+
+		/* Flipping a single input bit flips about half of the output bits */
+		for (const size_t size : { 1u, 3u, 8u, 16u, 17u, 48u, 100u })
+		{
+			String input{};
+			input.Assign(bytes.Data(), size);
+			const uint64_t hash{ input.Hash() };
+
+			size_t nrOfFlippedBits{};
+			for (size_t bit{}; bit < size * 8; ++bit)
+			{
+				input[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+				nrOfFlippedBits += static_cast<size_t>(std::popcount(hash ^ input.Hash()));
+				input[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+			}
+
+			const double average{ static_cast<double>(nrOfFlippedBits) / static_cast<double>(size * 8) };
+			REQUIRE(average > 24.0);
+			REQUIRE(average < 40.0);
+		}
+
+		std::unordered_map<String, int> ages{};
+		ages[String{ "Alice" }] = 30;
+		ages[String{ "Bob" }] = 25;
+		REQUIRE(ages.at(String{ "Alice" }) == 30);
+		REQUIRE(ages.count(String{ "Carol" }) == 0);
+	}
+
+	SECTION("Cached hash")
+	{
+		using CachedString = CustomString<char, std::allocator<char>, GrowOnePointFive, CachedHash>;
+
+		REQUIRE(sizeof(String) == sizeof(CustomString<char, std::allocator<char>, GrowOnePointFive, NoHashCache>));
+
+		CachedString str{ "The quick brown fox" };
+		REQUIRE(str.Hash() == String{ "The quick brown fox" }.Hash());
+		REQUIRE(str.Hash() == str.Hash());
+
+		/* Every mutator has to forget the cached hash */
+		const auto expectHashOf = [](const CachedString& cached, const char* pExpected)
+			{
+				return cached.Hash() == String{ pExpected }.Hash();
+			};
+
+		str.Append('!', 2);
+		REQUIRE(expectHashOf(str, "The quick brown fox!!"));
+		str += " jumps";
+		REQUIRE(expectHashOf(str, "The quick brown fox!! jumps"));
+		str += CachedString{ " over" };
+		REQUIRE(expectHashOf(str, "The quick brown fox!! jumps over"));
+		str.Assign('z', 3);
+		REQUIRE(expectHashOf(str, "zzz"));
+		str.Assign("lazy dog");
+		REQUIRE(expectHashOf(str, "lazy dog"));
+		str.ToUpper();
+		REQUIRE(expectHashOf(str, "LAZY DOG"));
+		str.ToLower();
+		REQUIRE(expectHashOf(str, "lazy dog"));
+		str[0] = 'h';
+		REQUIRE(expectHashOf(str, "hazy dog"));
+		str.Data()[1] = 'o';
+		REQUIRE(expectHashOf(str, "hozy dog"));
+		str.ResizeAndOverwrite(3, [](char* pData, const size_t) { pData[2] = 'x'; return size_t{ 3 }; });
+		REQUIRE(expectHashOf(str, "hox"));
+		str.Assign("");
+		REQUIRE(expectHashOf(str, ""));
+
+		/* Copies and moves carry the cache along with the characters, swaps exchange it */
+		CachedString a{ "Long enough to live on the heap" };
+		CachedString b{ "short" };
+		const size_t aHash{ a.Hash() };
+		const size_t bHash{ b.Hash() };
+
+		CachedString copy{ a };
+		REQUIRE(copy.Hash() == aHash);
+		copy = b;
+		REQUIRE(copy.Hash() == bHash);
+
+		a.Swap(b);
+		REQUIRE(a.Hash() == bHash);
+		REQUIRE(b.Hash() == aHash);
+
+		CachedString moved{ std::move(a) };
+		REQUIRE(moved.Hash() == bHash);
+		REQUIRE(a.Hash() == String{}.Hash());
+
+		/* Equality keeps working whether or not the hashes are cached */
+		CachedString c{ "short" };
+		REQUIRE(moved == c);
+		(void)c.Hash();
+		REQUIRE(moved == c);
+		c[0] = 'S';
+		REQUIRE(moved != c);
+		(void)c.Hash();
+		REQUIRE(moved != c);
+
+		/* A reference that is held on to can write after the hash was taken, so it stops the caching until the next assignment */
+		CachedString held{ "hello" };
+		const CachedString jello{ "jello" };
+		char& first{ held[0] };
+		(void)held.Hash();
+		(void)jello.Hash();
+		first = 'j';
+		REQUIRE(held == jello);
+		REQUIRE(held.Hash() == jello.Hash());
+
+		char* pHeld{ held.Data() };
+		(void)held.Hash();
+		pHeld[0] = 'y';
+		REQUIRE(held.Hash() == String{ "yello" }.Hash());
+		REQUIRE(held != jello);
+
+		held.Assign("jello");
+		(void)held.Hash();
+		REQUIRE(held == jello);
+
+		/* Reading only through the const accessors, or growing the buffer, keeps a valid cache */
+		CachedString grown{ "short" };
+		const size_t grownHash{ grown.Hash() };
+		grown.Reserve(100);
+		REQUIRE(std::as_const(grown).Data()[0] == 's');
+		REQUIRE(grown.Hash() == grownHash);
+
+		std::unordered_set<CachedString> set{};
+		set.insert(CachedString{ "Alice" });
+		REQUIRE(set.count(CachedString{ "Alice" }) == 1);
+	}
+
+	SECTION("Transparent lookup")
+	{
+		using Allocator = CountingAllocator<char, false>;
+		using AllocString = CustomString<char, Allocator>;
+
+		const CustomStringHash<char> hash{};
+		const CustomStringEqual<char> equal{};
+
+		const char* pKey{ "A key that does not fit inside the object" };
+		const String key{ pKey };
+
+		REQUIRE(hash(key) == hash(pKey));
+		REQUIRE(hash(key) == hash(std::string_view{ pKey }));
+		REQUIRE(hash(key) == hash(CustomString<char, std::allocator<char>, GrowOnePointFive, CachedHash>{ pKey }));
+		REQUIRE(hash(String{}) == hash(""));
+		REQUIRE(hash(String{}) == hash(std::string_view{}));
+
+		REQUIRE(equal(key, pKey));
+		REQUIRE(equal(pKey, key));
+		REQUIRE(equal(key, std::string_view{ pKey }));
+		REQUIRE(equal(key, String{ pKey }));
+		REQUIRE(!equal(key, "A key"));
+		REQUIRE(!equal(key, std::string_view{ pKey, 5 }));
+		REQUIRE(equal(String{}, ""));
+
+		/* Embedded nulls take part through the view, a null-terminated string stops at the first one */
+		String withNull{ "ab" };
+		withNull.Append('\0', 1);
+		withNull += "c";
+		REQUIRE(equal(withNull, std::string_view{ "ab\0c", 4 }));
+		REQUIRE(!equal(withNull, "ab"));
+		REQUIRE(hash(withNull) == hash(std::string_view{ "ab\0c", 4 }));
+
+		AllocationStats stats{};
+		std::unordered_map<AllocString, int, CustomStringHash<char>, CustomStringEqual<char>> map{};
+		map.emplace(AllocString{ pKey, Allocator{ &stats } }, 1);
+		map.emplace(AllocString{ "Another key that lives on the heap", Allocator{ &stats } }, 2);
+
+		const size_t nrOfAllocations{ stats.NrOfAllocations };
+
+		REQUIRE(map.find(pKey)->second == 1);
+		REQUIRE(map.find(std::string_view{ "Another key that lives on the heap" })->second == 2);
+		REQUIRE(map.find(key)->second == 1);
+		REQUIRE(map.count("A key that is not in the map, also too long to fit") == 0);
+		REQUIRE(map.contains(pKey));
+
+		REQUIRE(stats.NrOfAllocations == nrOfAllocations);
+	}
+
+	SECTION("Compare strings with embedded nulls")
+	{
+		String str{};
+		str.Assign("ab\0cd", 5);
+		String same{};
+		same.Assign("ab\0cd", 5);
+		String other{};
+		other.Assign("ab\0ce", 5);
+
+		REQUIRE(str == same);
+		REQUIRE(str != other);
+		REQUIRE(str != "ab");
+		REQUIRE(String{ "ab" } != str);
+
+		/* Long enough for the vectorized compare, with the difference behind the null */
+		String longStr{ 'a', 100 };
+		longStr[10] = '\0';
+		String longOther{ longStr };
+		REQUIRE(longStr == longOther);
+
+		longOther[99] = 'b';
+		REQUIRE(longStr != longOther);
+	}
+
 	SECTION("Test ToUpper()")
 	{
 		String str{ "Hello World!" };
@@ -210,7 +569,7 @@ TEST_CASE("Test Custom String")
 
 		REQUIRE(str.Size() == 12);
 		REQUIRE(str.Capacity() >= 12);
-		REQUIRE(str.MaxSize() == std::numeric_limits<size_t>::max());
+		REQUIRE(str.MaxSize() == std::numeric_limits<size_t>::max() / 2);
 		REQUIRE(str.Data() != nullptr);
 		REQUIRE(IsStringNullTerminated(str));
 
@@ -218,7 +577,7 @@ TEST_CASE("Test Custom String")
 
 		REQUIRE(str.Size() == 29);
 		REQUIRE(str.Capacity() >= 29);
-		REQUIRE(str.MaxSize() == std::numeric_limits<size_t>::max());
+		REQUIRE(str.MaxSize() == std::numeric_limits<size_t>::max() / 2);
 		REQUIRE(str.Data() != nullptr);
 		REQUIRE(str[12] != '\0');
 		REQUIRE(str[12] == ' ');
@@ -232,7 +591,7 @@ TEST_CASE("Test Custom String")
 
 		REQUIRE(str.Size() == 12);
 		REQUIRE(str.Capacity() >= 12);
-		REQUIRE(str.MaxSize() == std::numeric_limits<size_t>::max());
+		REQUIRE(str.MaxSize() == std::numeric_limits<size_t>::max() / 2);
 		REQUIRE(str.Data() != nullptr);
 		REQUIRE(IsStringNullTerminated(str));
 
@@ -241,7 +600,7 @@ TEST_CASE("Test Custom String")
 
 		REQUIRE(str.Size() == 29);
 		REQUIRE(str.Capacity() >= 29);
-		REQUIRE(str.MaxSize() == std::numeric_limits<size_t>::max());
+		REQUIRE(str.MaxSize() == std::numeric_limits<size_t>::max() / 2);
 		REQUIRE(str.Data() != nullptr);
 		REQUIRE(str[12] != '\0');
 		REQUIRE(str[12] == ' ');
@@ -352,4 +711,1918 @@ TEST_CASE("Test Custom String")
 		REQUIRE(string.Contains(string2));
 		REQUIRE(!string.Contains(string3));
 	}
-}
\ No newline at end of file
+
+	SECTION("Reserve and ShrinkToFit")
+	{
+		String string{};
+		string.Reserve(100);
+
+		REQUIRE(string.Capacity() >= 101);
+		REQUIRE(string.Size() == 0);
+		REQUIRE(string == "");
+		REQUIRE(IsStringNullTerminated(string));
+
+		const char* pData{ string.Data() };
+		string.Append('x', 100);
+		REQUIRE(string.Data() == pData);
+		REQUIRE(string.Size() == 100);
+
+		string.Assign("Hello World! This is Rhidian!");
+		string.ShrinkToFit();
+		REQUIRE(string.Capacity() == 30);
+		REQUIRE(string == "Hello World! This is Rhidian!");
+		REQUIRE(IsStringNullTerminated(string));
+
+		string.Assign("Hello World!");
+		string.ShrinkToFit();
+		REQUIRE(string.Capacity() < 30);
+		REQUIRE(string == "Hello World!");
+		REQUIRE(IsStringNullTerminated(string));
+	}
+
+	SECTION("ResizeUninitialized and ResizeAndOverwrite")
+	{
+		String string{ "Hello" };
+		string.ResizeUninitialized(12);
+		std::memcpy(string.Data() + 5, " World!", 7);
+
+		REQUIRE(string.Size() == 12);
+		REQUIRE(string == "Hello World!");
+		REQUIRE(IsStringNullTerminated(string));
+
+		String string2{};
+		string2.ResizeAndOverwrite(64, [](char* pData, const size_t size)
+			{
+				REQUIRE(size == 64);
+				std::memcpy(pData, "Written in place", 16);
+				return 16;
+			});
+
+		REQUIRE(string2.Size() == 16);
+		REQUIRE(string2.Capacity() >= 65);
+		REQUIRE(string2 == "Written in place");
+		REQUIRE(IsStringNullTerminated(string2));
+
+		string2.ResizeAndOverwrite(7, [](char*, const size_t) { return 7; });
+		REQUIRE(string2 == "Written");
+		REQUIRE(IsStringNullTerminated(string2));
+	}
+
+	SECTION("Growth policies")
+	{
+		CustomString<char, std::allocator<char>, GrowOnePointFive> oneHalf{ "This string is too long to be stored inline" };
+		CustomString<char, std::allocator<char>, GrowDouble> twice{ "This string is too long to be stored inline" };
+		CustomString<char, std::allocator<char>, GrowExact> exact{ "This string is too long to be stored inline" };
+		CustomString<char, std::allocator<char>, GrowPowerOfTwo> powerOfTwo{ "This string is too long to be stored inline" };
+		CustomString<char, std::allocator<char>, GrowToSizeClass<>> sizeClass{ "This string is too long to be stored inline" };
+
+		REQUIRE(oneHalf.Capacity() == 44);
+		REQUIRE(twice.Capacity() == 44);
+		REQUIRE(exact.Capacity() == 44);
+		REQUIRE(powerOfTwo.Capacity() == 64);
+		REQUIRE(sizeClass.Capacity() == 48);
+
+		oneHalf += "!";
+		twice += "!";
+		exact += "!";
+		powerOfTwo += "!";
+		sizeClass += "!";
+
+		REQUIRE(oneHalf.Capacity() == 66);
+		REQUIRE(twice.Capacity() == 88);
+		REQUIRE(exact.Capacity() == 45);
+		REQUIRE(powerOfTwo.Capacity() == 64);
+		REQUIRE(sizeClass.Capacity() == 48);
+
+		REQUIRE(oneHalf == "This string is too long to be stored inline!");
+		REQUIRE(sizeClass == "This string is too long to be stored inline!");
+		REQUIRE(IsStringNullTerminated(exact));
+
+		REQUIRE(MallocSizeClasses::RoundUp(1) == 16);
+		REQUIRE(MallocSizeClasses::RoundUp(128) == 128);
+		REQUIRE(MallocSizeClasses::RoundUp(129) == 160);
+		REQUIRE(MallocSizeClasses::RoundUp(257) == 320);
+		REQUIRE(GrowToSizeClass<BufferPool>::CalculateNewCapacity<char>(0, 33, String{}.MaxSize()) == BufferPool::RoundUp(33));
+		REQUIRE(GrowPowerOfTwo::CalculateNewCapacity<char>(0, 100, 100) == 100);
+
+		/* No policy grows past MaxSize(), whose top bit is taken by the small string flag */
+		const size_t maxSize{ String{}.MaxSize() };
+		const size_t nearlyFull{ maxSize - 10 };
+		REQUIRE(maxSize < (size_t(1) << (std::numeric_limits<size_t>::digits - 1)));
+		REQUIRE(GrowOnePointFive::CalculateNewCapacity<char>(nearlyFull, nearlyFull + 1, maxSize) == maxSize);
+		REQUIRE(GrowDouble::CalculateNewCapacity<char>(nearlyFull, nearlyFull + 1, maxSize) == maxSize);
+		REQUIRE(GrowPowerOfTwo::CalculateNewCapacity<char>(nearlyFull, nearlyFull + 1, maxSize) == maxSize);
+		REQUIRE(GrowToSizeClass<>::CalculateNewCapacity<char>(maxSize / 2, maxSize / 2 + 1, maxSize) <= maxSize);
+		REQUIRE(GrowToSizeClass<>::CalculateNewCapacity<char>(nearlyFull, nearlyFull + 1, maxSize) <= maxSize);
+	}
+
+	SECTION("Custom allocators")
+	{
+		using Allocator = CountingAllocator<char, false>;
+		using AllocString = CustomString<char, Allocator>;
+
+		AllocationStats stats{};
+		AllocationStats otherStats{};
+
+		{
+			AllocString string{ "Short", Allocator{ &stats } };
+			REQUIRE(stats.NrOfAllocations == 0);
+
+			string += " and now long enough to need the heap";
+			REQUIRE(stats.NrOfAllocations == 1);
+			REQUIRE(string == "Short and now long enough to need the heap");
+			REQUIRE(IsStringNullTerminated(string));
+
+			AllocString copy{ string };
+			REQUIRE(stats.NrOfAllocations == 2);
+			REQUIRE(copy.GetAllocator() == string.GetAllocator());
+
+			/* Unequal, non-propagating allocators force a copy on move assignment */
+			AllocString other{ Allocator{ &otherStats } };
+			other = std::move(copy);
+			REQUIRE(otherStats.NrOfAllocations == 1);
+			REQUIRE(other == "Short and now long enough to need the heap");
+			REQUIRE(other.GetAllocator() == Allocator{ &otherStats });
+
+			AllocString moved{ std::move(string) };
+			REQUIRE(stats.NrOfAllocations == 2);
+			REQUIRE(moved.GetAllocator() == Allocator{ &stats });
+		}
+
+		REQUIRE(stats.NrOfAllocations == stats.NrOfDeallocations);
+		REQUIRE(otherStats.NrOfAllocations == otherStats.NrOfDeallocations);
+	}
+
+	SECTION("Propagating allocators")
+	{
+		using Allocator = CountingAllocator<char, true>;
+		using AllocString = CustomString<char, Allocator>;
+
+		AllocationStats stats{};
+		AllocationStats otherStats{};
+
+		{
+			AllocString string{ "A string that lives on the heap", Allocator{ &stats } };
+			AllocString other{ "Another string that lives on the heap", Allocator{ &otherStats } };
+
+			other = string;
+			REQUIRE(other.GetAllocator() == Allocator{ &stats });
+			REQUIRE(otherStats.NrOfAllocations == otherStats.NrOfDeallocations);
+
+			AllocString third{ "A third string that lives on the heap", Allocator{ &otherStats } };
+			third.Swap(string);
+			REQUIRE(third.GetAllocator() == Allocator{ &stats });
+			REQUIRE(string.GetAllocator() == Allocator{ &otherStats });
+			REQUIRE(third == "A string that lives on the heap");
+			REQUIRE(string == "A third string that lives on the heap");
+		}
+
+		REQUIRE(stats.NrOfAllocations == stats.NrOfDeallocations);
+		REQUIRE(otherStats.NrOfAllocations == otherStats.NrOfDeallocations);
+	}
+
+	SECTION("Polymorphic allocators")
+	{
+		char buffer[1024]{};
+		std::pmr::monotonic_buffer_resource resource{ buffer, sizeof(buffer), std::pmr::null_memory_resource() };
+
+		pmr::CustomString<char> string{ "Hello World! This string does not fit inline.", &resource };
+		pmr::CustomString<char> copy{ string, &resource };
+
+		REQUIRE(string.Data() >= buffer);
+		REQUIRE(string.Data() < buffer + sizeof(buffer));
+		REQUIRE(copy.Data() >= buffer);
+		REQUIRE(copy.Data() < buffer + sizeof(buffer));
+		REQUIRE(copy == "Hello World! This string does not fit inline.");
+
+		String small{ "abc" };
+		String large{ "This string is too long to be stored inline" };
+		swap(small, large);
+		REQUIRE(small == "This string is too long to be stored inline");
+		REQUIRE(large == "abc");
+		REQUIRE(IsStringNullTerminated(small));
+		REQUIRE(IsStringNullTerminated(large));
+	}
+
+	SECTION("Small string optimization")
+	{
+		const auto isInline = [](const String& str)
+		{
+			const char* pObject{ reinterpret_cast<const char*>(&str) };
+			return str.Data() >= pObject && str.Data() < pObject + sizeof(String);
+		};
+
+		/* Pointer, size and capacity, with the inline buffer overlapping the pointer and capacity */
+		REQUIRE(sizeof(String) == 3 * sizeof(void*));
+
+		String string{ "Key" };
+		String string2{ "This string is too long to be stored inline" };
+
+		REQUIRE(isInline(string));
+		REQUIRE(!isInline(string2));
+		REQUIRE(string == "Key");
+		REQUIRE(IsStringNullTerminated(string));
+
+		String copy{ string };
+		REQUIRE(isInline(copy));
+		REQUIRE(copy == "Key");
+
+		String moved{ std::move(copy) };
+		REQUIRE(isInline(moved));
+		REQUIRE(moved == "Key");
+		REQUIRE(copy.Data() == nullptr);
+
+		string2 = string;
+		REQUIRE(isInline(string2));
+		REQUIRE(string2 == "Key");
+
+		string += " that grows past the inline buffer";
+		REQUIRE(!isInline(string));
+		REQUIRE(string == "Key that grows past the inline buffer");
+		REQUIRE(IsStringNullTerminated(string));
+
+		REQUIRE(isInline(string.Substring(4, 5)));
+		REQUIRE(string.Substring(4, 5) == "that ");
+
+		string.Assign("Short");
+		REQUIRE(string == "Short");
+		REQUIRE(IsStringNullTerminated(string));
+
+		String string3{ "abc" };
+		string3 += string3;
+		string3 += string3;
+		string3 += string3;
+		REQUIRE(string3 == "abcabcabcabcabcabcabcabc");
+		REQUIRE(string3.Size() == 24);
+		REQUIRE(string3.Capacity() >= 25);
+		REQUIRE(IsStringNullTerminated(string3));
+	}
+}
+
+TEST_CASE("Test String Arena")
+{
+	SECTION("Strings allocate from the arena")
+	{
+		StringArena arena{ 256 };
+
+		ArenaString<char> string{ "This string is too long to be stored inline", arena };
+		ArenaString<char> string2{ string };
+
+		REQUIRE(string == "This string is too long to be stored inline");
+		REQUIRE(string2 == string);
+		REQUIRE(string2.GetAllocator() == string.GetAllocator());
+		REQUIRE(arena.BytesUsed() >= 2 * string.Capacity());
+		REQUIRE(IsStringNullTerminated(string2));
+
+		string += " and it keeps on growing past the first block of the arena";
+		string += string;
+		REQUIRE(string.Size() == 2 * 101);
+		REQUIRE(arena.BytesReserved() > 256);
+		REQUIRE(IsStringNullTerminated(string));
+	}
+
+	SECTION("Reset reclaims everything at once")
+	{
+		StringArena arena{ 128 };
+
+		{
+			ArenaString<char> string{ "This string is too long to be stored inline", arena };
+			string.Append('x', 500);
+		}
+
+		const size_t reserved{ arena.BytesReserved() };
+		REQUIRE(arena.BytesUsed() > 0);
+
+		arena.Reset();
+		REQUIRE(arena.BytesUsed() == 0);
+
+		{
+			ArenaString<char> string{ "This string is too long to be stored inline", arena };
+			string.Append('x', 500);
+			REQUIRE(string.Size() == 543);
+		}
+
+		/* The blocks from before the reset got reused */
+		REQUIRE(arena.BytesReserved() == reserved);
+	}
+
+	SECTION("Moving between arenas copies")
+	{
+		StringArena arena{};
+		StringArena arena2{};
+
+		ArenaString<char> string{ "This string is too long to be stored inline", arena };
+		ArenaString<char> string2{ arena2 };
+
+		string2 = std::move(string);
+		REQUIRE(string2 == "This string is too long to be stored inline");
+		REQUIRE(string2.GetAllocator().GetArena() == &arena2);
+	}
+}
+
+TEST_CASE("Test Buffer Pool")
+{
+	SECTION("Released buffers get recycled")
+	{
+		BufferPool& pool{ BufferPool::GetThreadLocal() };
+		pool.Trim();
+		pool.ResetStats();
+
+		for (size_t i{}; i < 10; ++i)
+		{
+			PooledString<char> string{ "This string is too long to be stored inline" };
+			string += string;
+
+			REQUIRE(string == "This string is too long to be stored inlineThis string is too long to be stored inline");
+			REQUIRE(IsStringNullTerminated(string));
+		}
+
+		/* Only the very first round had to go to the heap */
+		const BufferPool::Stats& stats{ pool.GetStats() };
+		REQUIRE(stats.NrOfMisses == 2);
+		REQUIRE(stats.NrOfHits == 18);
+		REQUIRE(stats.HitRate() == Approx(0.9));
+		REQUIRE(pool.BytesRetained() > 0);
+
+		pool.Trim();
+		REQUIRE(pool.BytesRetained() == 0);
+	}
+
+	SECTION("Retention is bounded")
+	{
+		BufferPool pool{ 2 };
+
+		void* pBuffers[4]{};
+		for (void*& pBuffer : pBuffers)
+			pBuffer = pool.Allocate(40);
+
+		for (void* pBuffer : pBuffers)
+			pool.Deallocate(pBuffer, 40);
+
+		REQUIRE(pool.GetStats().NrOfRecycled == 2);
+		REQUIRE(pool.GetStats().NrOfDropped == 2);
+		REQUIRE(pool.BytesRetained() == 2 * BufferPool::RoundUp(40));
+
+		void* pLarge{ pool.Allocate(BufferPool::MaxPooledSize() + 1) };
+		pool.Deallocate(pLarge, BufferPool::MaxPooledSize() + 1);
+		REQUIRE(pool.GetStats().NrOfDropped == 3);
+	}
+
+	SECTION("Size classes")
+	{
+		REQUIRE(BufferPool::RoundUp(1) == BufferPool::GetClassSize(0));
+		REQUIRE(BufferPool::RoundUp(BufferPool::GetClassSize(3)) == BufferPool::GetClassSize(3));
+		REQUIRE(BufferPool::RoundUp(BufferPool::GetClassSize(3) + 1) == BufferPool::GetClassSize(4));
+
+		for (size_t i{ 1 }; i < BufferPool::NrOfSizeClasses; ++i)
+		{
+			REQUIRE(BufferPool::GetClassSize(i) >= BufferPool::GetClassSize(i - 1) * 3 / 2);
+			REQUIRE(BufferPool::GetClassSize(i) % 16 == 0);
+		}
+	}
+
+	SECTION("Every thread has its own pool")
+	{
+		BufferPool* pOtherPool{};
+
+		std::thread thread{ [&pOtherPool]()
+			{
+				PooledString<char> string{ "This string is too long to be stored inline" };
+				pOtherPool = &BufferPool::GetThreadLocal();
+			} };
+		thread.join();
+
+		REQUIRE(pOtherPool != &BufferPool::GetThreadLocal());
+	}
+
+	SECTION("Strings can outlive the pool of their thread")
+	{
+		bool isPoolDestroyed{};
+
+		std::thread thread{ [&isPoolDestroyed]()
+			{
+				/* Constructed before the pool, so destroyed after it during thread exit */
+				thread_local struct Outliver final
+				{
+					~Outliver()
+					{
+						*pIsPoolDestroyed = BufferPool::TryGetThreadLocal() == nullptr;
+						Text.Assign("Allocated and released after the pool is gone");
+					}
+
+					bool* pIsPoolDestroyed;
+					PooledString<char> Text;
+				} outliver{ &isPoolDestroyed, PooledString<char>{} };
+
+				outliver.Text.Assign("This string is too long to be stored inline");
+			} };
+		thread.join();
+
+		REQUIRE(isPoolDestroyed);
+	}
+
+	SECTION("Releasing a string during thread exit does not create a pool")
+	{
+		PooledString<char> text{ "Allocated by the pool of the main thread" };
+		bool hadPoolBeforeExit{ true };
+		bool hasPool{ true };
+
+		std::thread thread{ [&text, &hadPoolBeforeExit, &hasPool]()
+			{
+				/* Constructed first, so destroyed after the string below has released its buffer */
+				thread_local struct Checker final
+				{
+					~Checker()
+					{
+						*pHasPool = BufferPool::FindThreadLocal() != nullptr;
+					}
+
+					bool* pHasPool;
+				} checker{ &hasPool };
+
+				thread_local PooledString<char> moved{ std::move(text) };
+				hadPoolBeforeExit = BufferPool::FindThreadLocal() != nullptr;
+			} };
+		thread.join();
+
+		REQUIRE(!hadPoolBeforeExit);
+		REQUIRE(!hasPool);
+	}
+}
+
+TEST_CASE("Test Cow String")
+{
+	using Cow = CowString<char>;
+
+	SECTION("Copies share one buffer")
+	{
+		Cow string{ "This string is too long to be stored inline" };
+		Cow copy{ string };
+		Cow copy2{};
+		copy2 = copy;
+
+		REQUIRE(string.UseCount() == 3);
+		REQUIRE(copy.Data() == string.Data());
+		REQUIRE(copy2.Data() == string.Data());
+		REQUIRE(copy == string);
+		REQUIRE(copy == "This string is too long to be stored inline");
+		REQUIRE(copy.IndexOf("long") == 19);
+		REQUIRE(copy.Contains('!') == false);
+		REQUIRE(IsStringNullTerminated(copy.GetString()));
+
+		Cow moved{ std::move(copy2) };
+		REQUIRE(string.UseCount() == 3);
+		REQUIRE(copy2.UseCount() == 0);
+		REQUIRE(copy2.Size() == 0);
+	}
+
+	SECTION("Mutations detach")
+	{
+		Cow string{ "This string is too long to be stored inline" };
+		Cow copy{ string };
+		Cow copy2{ string };
+		Cow copy3{ string };
+		Cow copy4{ string };
+
+		copy += "!";
+		copy2.Append('x', 2);
+		copy3.ToUpper();
+		copy4.Assign("Replaced");
+
+		REQUIRE(string.UseCount() == 1);
+		REQUIRE(string == "This string is too long to be stored inline");
+		REQUIRE(copy == "This string is too long to be stored inline!");
+		REQUIRE(copy2 == "This string is too long to be stored inlinexx");
+		REQUIRE(copy3 == "THIS STRING IS TOO LONG TO BE STORED INLINE");
+		REQUIRE(copy4 == "Replaced");
+		REQUIRE(copy.Data() != string.Data());
+
+		/* A sole owner mutates in place */
+		const char* pData{ copy.Data() };
+		copy.ToLower();
+		REQUIRE(copy.Data() == pData);
+
+		string += string;
+		REQUIRE(string == "This string is too long to be stored inlineThis string is too long to be stored inline");
+	}
+
+	SECTION("Mutable element access stops sharing")
+	{
+		Cow string{ "Hello World!" };
+		Cow copy{ string };
+
+		char& c{ copy[0] };
+		REQUIRE(string == "Hello World!");
+		REQUIRE(copy.UseCount() == 1);
+
+		Cow copy2{ copy };
+		c = 'J';
+
+		REQUIRE(copy == "Jello World!");
+		REQUIRE(copy2 == "Hello World!");
+		REQUIRE(copy2.Data() != copy.Data());
+
+		/* Assigning a new value ends the reference, so copies share the buffer again */
+		copy.Assign("Hello again!");
+		Cow copy3{ copy };
+		REQUIRE(copy3.Data() == copy.Data());
+		REQUIRE(copy.UseCount() == 2);
+
+		/* So does growing into a new buffer */
+		Cow grown{ "Short" };
+		(void)grown[0];
+		const char* pOldData{ grown.Data() };
+		grown += " but grown far past the inline buffer";
+		REQUIRE(grown.Data() != pOldData);
+		Cow grownCopy{ grown };
+		REQUIRE(grownCopy.Data() == grown.Data());
+
+		/* Appending in place keeps the reference alive, so the buffer stays unshareable */
+		Cow inPlace{ "Short" };
+		char& first{ inPlace[0] };
+		inPlace += "er";
+		Cow inPlaceCopy{ inPlace };
+		first = 's';
+		REQUIRE(inPlace == "shorter");
+		REQUIRE(inPlaceCopy == "Shorter");
+	}
+
+	SECTION("Copies can cross threads")
+	{
+		Cow string{ "This string is too long to be stored inline" };
+		std::vector<std::thread> threads{};
+
+		for (size_t i{}; i < 4; ++i)
+		{
+			threads.emplace_back([copy = string]() mutable
+				{
+					for (size_t j{}; j < 1000; ++j)
+					{
+						Cow local{ copy };
+						local += "!";
+					}
+				});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		REQUIRE(string.UseCount() == 1);
+		REQUIRE(string == "This string is too long to be stored inline");
+	}
+}
+
+TEST_CASE("Test Shared String")
+{
+	using Shared = SharedString<char>;
+
+	SECTION("Freezing a CustomString")
+	{
+		String string{ "This string is too long to be stored inline" };
+		Shared shared{ string };
+
+		REQUIRE(shared.Size() == string.Size());
+		REQUIRE(shared.Data() != string.Data());
+		REQUIRE(shared == "This string is too long to be stored inline");
+		REQUIRE(shared != "This string is too long to be stored");
+		REQUIRE(shared[5] == 's');
+		REQUIRE(shared.ToCustomString() == string);
+		REQUIRE(IsStringNullTerminated(shared));
+	}
+
+	SECTION("Copies share the allocation")
+	{
+		Shared shared{ "Hello World!" };
+		Shared copy{ shared };
+		Shared copy2{};
+		copy2 = copy;
+
+		REQUIRE(shared.UseCount() == 3);
+		REQUIRE(copy.Data() == shared.Data());
+		REQUIRE(copy2 == shared);
+
+		Shared moved{ std::move(copy2) };
+		REQUIRE(shared.UseCount() == 3);
+		REQUIRE(copy2.Size() == 0);
+		REQUIRE(copy2 == "");
+	}
+
+	SECTION("Equality")
+	{
+		Shared shared{ "Hello World!" };
+		Shared same{ "Hello World!" };
+		Shared different{ "Hello World?" };
+		Shared empty{};
+		Shared empty2{ "" };
+
+		REQUIRE(shared.Hash() == same.Hash());
+		REQUIRE(shared == same);
+		REQUIRE(shared != different);
+		REQUIRE(shared != empty);
+		REQUIRE(empty == empty2);
+		REQUIRE(empty.Hash() == empty2.Hash());
+		REQUIRE(shared.Hash() == String{ "Hello World!" }.Hash());
+	}
+
+	SECTION("Embedded nulls")
+	{
+		Shared shared{ "a\0bc", 4 };
+
+		/* A heap buffer of exactly two characters, reading past its null would be caught by the sanitizers */
+		const std::unique_ptr<char[]> pShort{ std::make_unique<char[]>(2) };
+		pShort[0] = 'a';
+		REQUIRE(shared != pShort.get());
+		REQUIRE(shared != "a");
+
+		/* A trailing null survives the round trip */
+		Shared trailing{ "ab\0", 3 };
+		const String string{ trailing.ToCustomString() };
+		REQUIRE(string.Size() == 3);
+		REQUIRE(string[2] == '\0');
+		REQUIRE(Shared{ string } == trailing);
+
+		REQUIRE(Shared{}.ToCustomString().Size() == 0);
+	}
+
+	SECTION("Copies can cross threads")
+	{
+		Shared shared{ "This string is too long to be stored inline" };
+		std::vector<std::thread> threads{};
+		std::atomic<size_t> totalSize{};
+
+		for (size_t i{}; i < 4; ++i)
+		{
+			threads.emplace_back([shared, &totalSize]()
+				{
+					for (size_t j{}; j < 1000; ++j)
+					{
+						Shared local{ shared };
+						totalSize += local.Size();
+					}
+				});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		REQUIRE(shared.UseCount() == 1);
+		REQUIRE(totalSize == 4 * 1000 * 43);
+	}
+}
+
+TEST_CASE("Test String Interner")
+{
+	using Interner = StringInterner<char>;
+	using Handle = Interner::Handle;
+
+	SECTION("Equal contents give equal handles")
+	{
+		Interner interner{};
+
+		const Handle first{ interner.Intern("cpu.usage") };
+		const Handle second{ interner.Intern(String{ "cpu.usage" }) };
+		const Handle third{ interner.Intern("cpu.usage.total", 9) };
+		const Handle other{ interner.Intern("mem.usage") };
+
+		REQUIRE(first == second);
+		REQUIRE(first == third);
+		REQUIRE(first != other);
+		REQUIRE(interner.Size() == 2);
+
+		REQUIRE(first.Size() == 9);
+		REQUIRE(std::strcmp(first.Data(), "cpu.usage") == 0);
+		REQUIRE(IsStringNullTerminated(first));
+		REQUIRE(first.GetId() != other.GetId());
+	}
+
+	SECTION("Empty strings")
+	{
+		Interner interner{};
+
+		const Handle empty{ interner.Intern("") };
+
+		REQUIRE(empty == Handle{});
+		REQUIRE(empty.Size() == 0);
+		REQUIRE(empty.GetId() == Interner::EmptyId);
+		REQUIRE(IsStringNullTerminated(empty));
+		REQUIRE(interner.Size() == 0);
+		REQUIRE(empty.Hash() == String{}.Hash());
+		REQUIRE(empty.Hash() == SharedString<char>{}.Hash());
+	}
+
+	SECTION("Lookup")
+	{
+		Interner interner{};
+
+		REQUIRE(interner.Find("cpu.usage") == Handle{});
+
+		const Handle handle{ interner.Intern("cpu.usage") };
+
+		REQUIRE(interner.Find("cpu.usage") == handle);
+		REQUIRE(interner.Find("cpu") == Handle{});
+		REQUIRE(interner.FromId(handle.GetId()) == handle);
+		REQUIRE(interner.FromId(Interner::EmptyId) == Handle{});
+	}
+
+	SECTION("Handles stay valid while the table grows")
+	{
+		Interner interner{ 256 };
+		std::vector<String> names{};
+		std::vector<Handle> handles{};
+
+		for (size_t i{}; i < 1000; ++i)
+		{
+			String name{ "metric." };
+			name += String{ static_cast<char>('a' + i % 26), i / 26 + 1 };
+			names.push_back(name);
+			handles.push_back(interner.Intern(name));
+		}
+
+		REQUIRE(interner.Size() == 1000);
+
+		for (size_t i{}; i < 1000; ++i)
+		{
+			REQUIRE(handles[i] == interner.Intern(names[i]));
+			REQUIRE(handles[i].Size() == names[i].Size());
+			REQUIRE(std::memcmp(handles[i].Data(), names[i].Data(), names[i].Size()) == 0);
+			REQUIRE(interner.FromId(handles[i].GetId()) == handles[i]);
+		}
+
+		REQUIRE(interner.Size() == 1000);
+	}
+
+	SECTION("Bulk interning")
+	{
+		Interner interner{};
+
+		const char* pNames[]{ "cpu", "mem", "cpu", "disk", "" };
+		Handle handles[5]{};
+
+		Handle* pEnd{ interner.InternAll(std::begin(pNames), std::end(pNames), handles) };
+
+		REQUIRE(pEnd == std::end(handles));
+		REQUIRE(interner.Size() == 3);
+		REQUIRE(handles[0] == handles[2]);
+		REQUIRE(handles[0] != handles[1]);
+		REQUIRE(handles[3] == interner.Find("disk"));
+		REQUIRE(handles[4] == Handle{});
+	}
+
+	SECTION("Memory accounting")
+	{
+		Interner interner{};
+
+		REQUIRE(interner.GetMemoryUsage().TotalBytes() == 0);
+
+		interner.Reserve(100);
+		(void)interner.Intern("cpu.usage");
+
+		const Interner::MemoryUsage usage{ interner.GetMemoryUsage() };
+
+		REQUIRE(usage.StringBytes >= 10);
+		REQUIRE(usage.ArenaBytes >= usage.StringBytes);
+		REQUIRE(usage.TableBytes >= 200 * sizeof(void*));
+		REQUIRE(usage.TotalBytes() == usage.ArenaBytes + usage.TableBytes);
+	}
+
+	SECTION("Interning a known string does not grow the table")
+	{
+		Interner interner{};
+		const Handle first{ interner.Intern("key 0") };
+
+		/* Passes through every load factor, including a table that is exactly half full */
+		for (size_t i{ 1 }; i < 100; ++i)
+		{
+			const std::string key{ "key " + std::to_string(i) };
+			(void)interner.Intern(key.c_str());
+
+			const size_t tableBytes{ interner.GetMemoryUsage().TableBytes };
+			REQUIRE(interner.Intern("key 0") == first);
+			REQUIRE(interner.Intern(key.c_str()) == interner.Find(key.c_str()));
+			REQUIRE(interner.GetMemoryUsage().TableBytes == tableBytes);
+		}
+	}
+}
+
+TEST_CASE("Test String Search")
+{
+	using StringSearch::InstructionSet;
+
+	std::vector<InstructionSet> instructionSets{ InstructionSet::Scalar };
+	if (StringSearch::GetInstructionSet() >= InstructionSet::SSE2)
+		instructionSets.push_back(InstructionSet::SSE2);
+	if (StringSearch::GetInstructionSet() >= InstructionSet::SSSE3)
+		instructionSets.push_back(InstructionSet::SSSE3);
+	if (StringSearch::GetInstructionSet() >= InstructionSet::AVX2)
+		instructionSets.push_back(InstructionSet::AVX2);
+
+	SECTION("FindByte finds the first match for every size and position")
+	{
+		/* Covers the scalar tails, the overlapping final loads and the unrolled AVX2 loop */
+		std::vector<unsigned char> bytes(200, 'a');
+
+		for (const InstructionSet set : instructionSets)
+		{
+			for (size_t size{}; size <= bytes.size(); ++size)
+			{
+				REQUIRE(StringSearch::FindByte(bytes.data(), size, 'x', set) == nullptr);
+
+				for (size_t position{}; position < size; ++position)
+				{
+					bytes[position] = 'x';
+					if (position + 1 < size)
+						bytes[size - 1] = 'x';
+
+					REQUIRE(StringSearch::FindByte(bytes.data(), size, 'x', set) == bytes.data() + position);
+
+					bytes[position] = 'a';
+					bytes[size - 1] = 'a';
+				}
+			}
+		}
+	}
+
+	SECTION("Equals agrees with memcmp")
+	{
+		std::vector<unsigned char> a(200);
+		for (size_t i{}; i < a.size(); ++i)
+			a[i] = static_cast<unsigned char>(i * 7);
+
+		for (const InstructionSet set : instructionSets)
+		{
+			for (size_t size{}; size <= a.size(); ++size)
+			{
+				std::vector<unsigned char> b(a);
+				REQUIRE(StringSearch::Equals(a.data(), b.data(), size, set));
+
+				for (size_t position{}; position < size; ++position)
+				{
+					b[position] ^= 0x80;
+					REQUIRE(!StringSearch::Equals(a.data(), b.data(), size, set));
+					b[position] ^= 0x80;
+				}
+			}
+		}
+	}
+
+	SECTION("FindMismatch finds the first difference")
+	{
+		std::vector<unsigned char> a(200);
+		for (size_t i{}; i < a.size(); ++i)
+			a[i] = static_cast<unsigned char>(i * 13);
+
+		for (const InstructionSet set : instructionSets)
+		{
+			for (size_t size{}; size <= a.size(); ++size)
+			{
+				std::vector<unsigned char> b(a);
+				REQUIRE(StringSearch::FindMismatch(a.data(), b.data(), size, set) == size);
+
+				for (size_t position{}; position < size; ++position)
+				{
+					/* A second difference further on must not be reported instead */
+					b[position] ^= 1;
+					b[size - 1] ^= 2;
+					REQUIRE(StringSearch::FindMismatch(a.data(), b.data(), size, set) == position);
+					b[size - 1] ^= 2;
+					b[position] ^= 1;
+				}
+			}
+		}
+	}
+
+	SECTION("FindByte does not read outside of the range")
+	{
+		std::vector<unsigned char> bytes(100, 'x');
+
+		for (const InstructionSet set : instructionSets)
+		{
+			for (size_t size{}; size < 40; ++size)
+				REQUIRE(StringSearch::FindByte(bytes.data() + 50, size, 'a', set) == nullptr);
+		}
+	}
+
+	SECTION("IndexOf and Contains on long strings")
+	{
+		String string{ 'a', 5000 };
+		string[4321] = 'b';
+		string[4999] = 'c';
+
+		REQUIRE(string.IndexOf('a') == 0);
+		REQUIRE(string.IndexOf('b') == 4321);
+		REQUIRE(string.IndexOf('c') == 4999);
+		REQUIRE(string.IndexOf('d') == String::NoPos);
+		REQUIRE(string.Contains('b'));
+		REQUIRE(!string.Contains('d'));
+		REQUIRE(String{}.IndexOf('a') == String::NoPos);
+	}
+
+	SECTION("FindSubstring agrees with a naive search")
+	{
+		const auto naiveSearch = [](const String& haystack, const String& needle)
+		{
+			for (size_t i{}; i + needle.Size() <= haystack.Size(); ++i)
+			{
+				if (std::memcmp(haystack.Data() + i, needle.Data(), needle.Size()) == 0)
+					return i;
+			}
+
+			return String::NoPos;
+		};
+
+		/* Small alphabets produce lots of periodic needles and partial matches */
+		uint32_t seed{ 12345 };
+		const auto random = [&seed](const uint32_t max)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			return (seed >> 16) % max;
+		};
+
+		for (size_t iteration{}; iteration < 3000; ++iteration)
+		{
+			const uint32_t alphabetSize{ 1 + random(3) };
+
+			String haystack{};
+			for (size_t i{}, size{ random(60) }; i < size; ++i)
+				haystack += String{ static_cast<char>('a' + random(alphabetSize)), 1 };
+
+			String needle{};
+			for (size_t i{}, size{ 1 + random(8) }; i < size; ++i)
+				needle += String{ static_cast<char>('a' + random(alphabetSize)), 1 };
+
+			REQUIRE(haystack.IndexOf(needle) == naiveSearch(haystack, needle));
+		}
+	}
+
+	SECTION("FindBytes agrees with FindSubstring")
+	{
+		uint32_t seed{ 54321 };
+		const auto random = [&seed](const uint32_t max)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			return (seed >> 16) % max;
+		};
+
+		for (const InstructionSet set : instructionSets)
+		{
+			for (size_t iteration{}; iteration < 2000; ++iteration)
+			{
+				const uint32_t alphabetSize{ 1 + random(4) };
+
+				std::vector<char> haystack(random(300));
+				for (char& c : haystack)
+					c = static_cast<char>('a' + random(alphabetSize));
+
+				std::vector<char> needle(1 + random(40));
+				for (char& c : needle)
+					c = static_cast<char>('a' + random(alphabetSize));
+
+				const void* pExpected{ StringSearch::FindSubstring(haystack.data(), haystack.size(), needle.data(), needle.size()) };
+
+				REQUIRE(StringSearch::FindBytes(haystack.data(), haystack.size(), needle.data(), needle.size(), set) == pExpected);
+			}
+		}
+	}
+
+	SECTION("FindBytes falls back when candidates keep failing")
+	{
+		/* Every position matches the first and last byte of the needle, but none of them is a match */
+		String haystack{ 'a', 20000 };
+		haystack += "ba";
+
+		String needle{ 'a', 52 };
+		needle[50] = 'b';
+
+		for (const InstructionSet set : instructionSets)
+		{
+			const void* pMatch{ StringSearch::FindBytes(haystack.Data(), haystack.Size(), needle.Data(), needle.Size(), set) };
+
+			REQUIRE(pMatch == haystack.Data() + 20000 - 50);
+		}
+
+		REQUIRE(haystack.IndexOf(needle) == 20000 - 50);
+		REQUIRE(haystack.Contains(needle));
+		REQUIRE(!haystack.Contains("bb"));
+
+		/* Matches around the point where the fallback takes over are found exactly once */
+		for (size_t position{}; position < 300; ++position)
+		{
+			std::string text(position + 50, 'a');
+			text += "ba";
+			text.append(100, 'a');
+
+			for (const InstructionSet set : instructionSets)
+			{
+				const void* pMatch{ StringSearch::FindBytes(text.data(), text.size(), needle.Data(), needle.Size(), set) };
+
+				REQUIRE(pMatch == text.data() + position);
+			}
+		}
+	}
+
+	SECTION("Searcher agrees with IndexOf")
+	{
+		uint32_t seed{ 4242 };
+		const auto random = [&seed](const uint32_t max)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			return (seed >> 16) % max;
+		};
+
+		for (size_t iteration{}; iteration < 2000; ++iteration)
+		{
+			const uint32_t alphabetSize{ 1 + random(4) };
+
+			String haystack{};
+			for (size_t i{}, size{ random(200) }; i < size; ++i)
+				haystack += String{ static_cast<char>('a' + random(alphabetSize)), 1 };
+
+			String needle{};
+			for (size_t i{}, size{ 1 + random(10) }; i < size; ++i)
+				needle += String{ static_cast<char>('a' + random(alphabetSize)), 1 };
+
+			const Searcher<char> searcher{ needle };
+
+			REQUIRE(haystack.IndexOf(searcher) == haystack.IndexOf(needle));
+		}
+
+		/* The same with null characters, which needles can contain and end in */
+		const char alphabet[]{ '\0', 'a', 'b' };
+		for (size_t iteration{}; iteration < 2000; ++iteration)
+		{
+			String haystack{};
+			for (size_t i{}, size{ random(100) }; i < size; ++i)
+				haystack += String{ alphabet[random(3)], 1 };
+
+			String needle{};
+			for (size_t i{}, size{ 1 + random(6) }; i < size; ++i)
+				needle += String{ alphabet[random(3)], 1 };
+
+			const Searcher<char> searcher{ needle };
+
+			REQUIRE(searcher.GetNeedle().Size() == needle.Size());
+			REQUIRE(haystack.IndexOf(searcher) == haystack.IndexOf(needle));
+		}
+
+		String haystack{ "abx" };
+		haystack.Append('\0', 1);
+		String needle{ "b" };
+		needle.Append('\0', 1);
+		REQUIRE(haystack.IndexOf(Searcher<char>{ needle }) == String::NoPos);
+		REQUIRE(haystack.IndexOf(Searcher<char>{ "b\0", 2 }) == haystack.IndexOf(needle));
+	}
+
+	SECTION("Searcher reuse")
+	{
+		const Searcher<char> searcher{ "needle" };
+
+		REQUIRE(searcher.GetNeedle() == "needle");
+		REQUIRE(String{ "haystack with a needle" }.IndexOf(searcher) == 16);
+		REQUIRE(String{ "needle" }.IndexOf(searcher) == 0);
+		REQUIRE(String{ "needl" }.IndexOf(searcher) == String::NoPos);
+		REQUIRE(String{}.IndexOf(searcher) == String::NoPos);
+		REQUIRE(searcher.FindIn("a needle", 8) == 2);
+
+		const Searcher<wchar_t> wideSearcher{ L"\u0101\u0201" };
+		REQUIRE(CustomString<wchar_t>{ L"\u0201\u0101\u0101\u0201" }.IndexOf(wideSearcher) == 2);
+	}
+
+	SECTION("IndexOf with periodic needles")
+	{
+		String haystack{ 'a', 1000 };
+		haystack += "b";
+
+		String needle{ 'a', 100 };
+		needle += "b";
+
+		REQUIRE(haystack.IndexOf(needle) == 900);
+		REQUIRE(haystack.IndexOf(String{ 'a', 1001 }) == String::NoPos);
+		REQUIRE(haystack.IndexOf("ab") == 999);
+		REQUIRE(haystack.IndexOf("ba") == String::NoPos);
+		REQUIRE(String{ "abababc" }.IndexOf("ababc") == 2);
+		REQUIRE(String{ "abcabcabd" }.IndexOf("abcabd") == 3);
+		REQUIRE(String{ "Hello" }.IndexOf("") == 0);
+	}
+
+	SECTION("An empty needle matches both kinds of empty string")
+	{
+		/* A default string has no buffer, an assigned "" lives in the small buffer */
+		const String unallocated{};
+		const String small{ "" };
+		REQUIRE(unallocated.Data() == nullptr);
+		REQUIRE(small.Data() != nullptr);
+
+		for (const String* pString : { &unallocated, &small })
+		{
+			REQUIRE(pString->IndexOf("") == 0);
+			REQUIRE(pString->IndexOf(String{}) == 0);
+			REQUIRE(pString->LastIndexOf("") == 0);
+			REQUIRE(pString->LastIndexOf(String{}) == 0);
+			REQUIRE(pString->IndexOfIgnoreCase("") == 0);
+			REQUIRE(pString->Contains(""));
+			REQUIRE(pString->Contains(String{}));
+			REQUIRE(pString->StartsWith(""));
+			REQUIRE(pString->StartsWith(String{}));
+			REQUIRE(pString->EndsWith(""));
+			REQUIRE(pString->EndsWith(String{}));
+			REQUIRE(pString->StartsWithIgnoreCase(""));
+			REQUIRE(pString->EndsWithIgnoreCase(""));
+			REQUIRE(pString->Count("") == 0);
+		}
+
+		const String hello{ "Hello" };
+		REQUIRE(hello.LastIndexOf("") == hello.Size());
+		REQUIRE(hello.StartsWith(String{}));
+		REQUIRE(hello.EndsWith(String{}));
+	}
+
+	SECTION("FindLastByte finds the last match for every size and position")
+	{
+		std::vector<unsigned char> bytes(200, 'a');
+
+		for (const InstructionSet set : instructionSets)
+		{
+			for (size_t size{}; size <= bytes.size(); ++size)
+			{
+				REQUIRE(StringSearch::FindLastByte(bytes.data(), size, 'x', set) == nullptr);
+
+				for (size_t position{}; position < size; ++position)
+				{
+					bytes[position] = 'x';
+					bytes[0] = 'x';
+
+					REQUIRE(StringSearch::FindLastByte(bytes.data(), size, 'x', set) == bytes.data() + position);
+
+					bytes[position] = 'a';
+					bytes[0] = 'a';
+				}
+			}
+		}
+	}
+
+	SECTION("FindLastBytes agrees with a naive backwards search")
+	{
+		uint32_t seed{ 999 };
+		const auto random = [&seed](const uint32_t max)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			return (seed >> 16) % max;
+		};
+
+		for (const InstructionSet set : instructionSets)
+		{
+			for (size_t iteration{}; iteration < 2000; ++iteration)
+			{
+				const uint32_t alphabetSize{ 1 + random(4) };
+
+				std::vector<char> haystack(random(300));
+				for (char& c : haystack)
+					c = static_cast<char>('a' + random(alphabetSize));
+
+				std::vector<char> needle(1 + random(40));
+				for (char& c : needle)
+					c = static_cast<char>('a' + random(alphabetSize));
+
+				const char* pExpected{};
+				for (size_t i{ haystack.size() + 1 }; i-- > 0 && !pExpected;)
+				{
+					if (i + needle.size() <= haystack.size() && std::memcmp(haystack.data() + i, needle.data(), needle.size()) == 0)
+						pExpected = haystack.data() + i;
+				}
+
+				REQUIRE(StringSearch::FindLastSubstring(haystack.data(), haystack.size(), needle.data(), needle.size()) == pExpected);
+				REQUIRE(StringSearch::FindLastBytes(haystack.data(), haystack.size(), needle.data(), needle.size(), set) == pExpected);
+			}
+		}
+
+		/* Every position is a candidate, so the fallback takes over. Matches around that point are still found */
+		std::string needle{ "ab" };
+		needle.append(50, 'a');
+		for (size_t distanceFromEnd{}; distanceFromEnd < 300; ++distanceFromEnd)
+		{
+			std::string text(100, 'a');
+			text += needle;
+			text.append(distanceFromEnd, 'a');
+
+			for (const InstructionSet set : instructionSets)
+				REQUIRE(StringSearch::FindLastBytes(text.data(), text.size(), needle.data(), needle.size(), set) == text.data() + 100);
+		}
+	}
+
+	SECTION("LastIndexOf")
+	{
+		const String path{ "/usr/local/share/some.archive.tar.gz" };
+
+		REQUIRE(path.LastIndexOf('/') == 16);
+		REQUIRE(path.LastIndexOf('.') == 33);
+		REQUIRE(path.LastIndexOf('x') == String::NoPos);
+		REQUIRE(path.LastIndexOf(".tar") == 29);
+		REQUIRE(path.LastIndexOf(String{ "/" }) == 16);
+		REQUIRE(path.LastIndexOf("/usr/local/share/some.archive.tar.gz") == 0);
+		REQUIRE(path.LastIndexOf("/usr/local/share/some.archive.tar.gz!") == String::NoPos);
+		REQUIRE(String{}.LastIndexOf('a') == String::NoPos);
+		REQUIRE(String{}.LastIndexOf("a") == String::NoPos);
+
+		String longPath{ 'a', 5000 };
+		longPath[10] = '/';
+		longPath[4000] = '/';
+
+		REQUIRE(longPath.LastIndexOf('/') == 4000);
+		REQUIRE(longPath.LastIndexOf("a/a") == 3999);
+		REQUIRE(longPath.LastIndexOf("/aaa") == 4000);
+		REQUIRE(longPath.LastIndexOf("//") == String::NoPos);
+
+		const CustomString<wchar_t> widePath{ L"C:\\Users\\Some\\File.txt" };
+		REQUIRE(widePath.LastIndexOf(L'\\') == 13);
+		REQUIRE(widePath.LastIndexOf(L"\\") == 13);
+	}
+
+	SECTION("CharSet")
+	{
+		CharSet set{ " \t\r\n" };
+		set.AddRange('0', '9').Add(static_cast<unsigned char>(200));
+
+		REQUIRE(set.Count() == 15);
+		REQUIRE(set.Contains(' '));
+		REQUIRE(set.Contains('5'));
+		REQUIRE(set.Contains(200));
+		REQUIRE(!set.Contains('a'));
+		REQUIRE(!set.Contains(0));
+
+		set.Remove('5');
+		REQUIRE(!set.Contains('5'));
+		REQUIRE(set.Complement().Count() == 256 - 14);
+		REQUIRE(set.Complement().Contains('5'));
+		REQUIRE(!set.Complement().Contains(' '));
+
+		static_assert(CharSet{ "abc" }.Contains('b'), "CharSet is usable at compile time");
+	}
+
+	SECTION("FindAnyOf and FindNoneOf agree with a scalar classification")
+	{
+		uint32_t seed{ 31337 };
+		const auto random = [&seed](const uint32_t max)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			return (seed >> 16) % max;
+		};
+
+		for (size_t iteration{}; iteration < 500; ++iteration)
+		{
+			/* Sets of every density, over the full byte range */
+			CharSet set{};
+			const uint32_t density{ 1 + random(64) };
+			for (unsigned c{}; c < 256; ++c)
+			{
+				if (random(256) < density)
+					set.Add(static_cast<unsigned char>(c));
+			}
+
+			std::vector<unsigned char> bytes(random(150));
+			for (unsigned char& byte : bytes)
+				byte = static_cast<unsigned char>(random(256));
+
+			const unsigned char* pFirstIn{};
+			const unsigned char* pFirstOut{};
+			for (const unsigned char& byte : bytes)
+			{
+				if (!pFirstIn && set.Contains(byte))
+					pFirstIn = &byte;
+				if (!pFirstOut && !set.Contains(byte))
+					pFirstOut = &byte;
+			}
+
+			for (const InstructionSet instructionSet : instructionSets)
+			{
+				REQUIRE(StringSearch::FindAnyOf(bytes.data(), bytes.size(), set, instructionSet) == pFirstIn);
+				REQUIRE(StringSearch::FindNoneOf(bytes.data(), bytes.size(), set, instructionSet) == pFirstOut);
+			}
+		}
+	}
+
+	SECTION("IndexOfAny, IndexOfNotAny, Span and ComplementSpan")
+	{
+		const CharSet delimiters{ " ,;" };
+		const String line{ "   key1,key2;;  key3" };
+
+		REQUIRE(line.IndexOfAny(delimiters) == 0);
+		REQUIRE(line.IndexOfNotAny(delimiters) == 3);
+		REQUIRE(line.Span(delimiters) == 3);
+		REQUIRE(line.ComplementSpan(delimiters) == 0);
+		REQUIRE(line.Substring(3, line.Size()).ComplementSpan(delimiters) == 4);
+		REQUIRE(line.IndexOfAny(CharSet{ "xz" }) == String::NoPos);
+		REQUIRE(line.ComplementSpan(CharSet{ "xz" }) == line.Size());
+		REQUIRE(String{}.IndexOfAny(delimiters) == String::NoPos);
+		REQUIRE(String{}.Span(delimiters) == 0);
+
+		String longLine{ 'a', 3000 };
+		longLine[2500] = ';';
+		REQUIRE(longLine.IndexOfAny(delimiters) == 2500);
+		REQUIRE(longLine.Span(CharSet{ "a" }) == 2500);
+
+		const CustomString<wchar_t> wideLine{ L"\u0120abc def" };
+		REQUIRE(wideLine.IndexOfAny(CharSet{ " " }) == 4);
+		REQUIRE(wideLine.IndexOfNotAny(CharSet{ " " }) == 0);
+		REQUIRE(wideLine.Span(CharSet{}.Complement()) == 0);
+	}
+
+	SECTION("Count and FindAll")
+	{
+		const String text{ "aaaa abab aa" };
+
+		REQUIRE(text.Count("aa") == 3);
+		REQUIRE(text.Count("aa", true) == 4);
+		REQUIRE(text.Count(String{ "ab" }) == 2);
+		REQUIRE(text.Count("aba", true) == 1);
+		REQUIRE(text.Count("x") == 0);
+		REQUIRE(text.Count("") == 0);
+		REQUIRE(String{}.Count("a") == 0);
+
+		/* The range does not copy the needle, so a temporary one would dangle */
+		STATIC_REQUIRE(!CanFindAllInTemporary<String>);
+
+		std::vector<size_t> offsets{};
+		for (const size_t offset : text.FindAll("aa"))
+			offsets.push_back(offset);
+		REQUIRE(offsets == std::vector<size_t>{ 0, 2, 10 });
+
+		offsets.clear();
+		for (const size_t offset : text.FindAll("aa", true))
+			offsets.push_back(offset);
+		REQUIRE(offsets == std::vector<size_t>{ 0, 1, 2, 10 });
+
+		auto range{ text.FindAll("b") };
+		auto it{ range.begin() };
+		REQUIRE(*it++ == 6);
+		REQUIRE(*it == 8);
+		REQUIRE(++it == range.end());
+		REQUIRE(text.FindAll("zz").begin() == range.end());
+
+		const CustomString<wchar_t> wideText{ L"one, two, three" };
+		REQUIRE(wideText.Count(L", ") == 2);
+		REQUIRE(wideText.Count(L"e") == 3);
+	}
+
+	SECTION("FindAll agrees with a naive search")
+	{
+		uint32_t seed{ 4242 };
+		const auto random = [&seed](const uint32_t max)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			return (seed >> 16) % max;
+		};
+
+		for (size_t iteration{}; iteration < 300; ++iteration)
+		{
+			/* Small alphabets and long haystacks, so matches are dense and the SIMD kernels are used */
+			const uint32_t alphabet{ 1 + random(3) };
+			String haystack{ 'a', 1 + random(400) };
+			for (size_t i{}; i < haystack.Size(); ++i)
+				haystack[i] = static_cast<char>('a' + random(alphabet));
+
+			String needle{ 'a', 1 + random(6) };
+			for (size_t i{}; i < needle.Size(); ++i)
+				needle[i] = static_cast<char>('a' + random(alphabet));
+
+			for (const bool overlapping : { false, true })
+			{
+				std::vector<size_t> expected{};
+				for (size_t i{}; i + needle.Size() <= haystack.Size();)
+				{
+					if (std::memcmp(haystack.Data() + i, needle.Data(), needle.Size()) == 0)
+					{
+						expected.push_back(i);
+						i += overlapping ? 1 : needle.Size();
+					}
+					else
+					{
+						++i;
+					}
+				}
+
+				std::vector<size_t> offsets{};
+				for (const size_t offset : haystack.FindAll(needle, overlapping))
+					offsets.push_back(offset);
+
+				REQUIRE(offsets == expected);
+				REQUIRE(haystack.Count(needle, overlapping) == expected.size());
+			}
+		}
+	}
+
+	SECTION("FindAll does not allocate")
+	{
+		using Allocator = CountingAllocator<char, false>;
+
+		AllocationStats stats{};
+		CustomString<char, Allocator> text{ 'a', 1000, Allocator{ &stats } };
+		const CustomString<char, Allocator> needle{ "aa", Allocator{ &stats } };
+
+		const size_t nrOfAllocations{ stats.NrOfAllocations };
+
+		REQUIRE(text.Count(needle) == 500);
+		REQUIRE(text.Count("aaa", true) == 998);
+
+		size_t sum{};
+		for (const size_t offset : text.FindAll(needle))
+			sum += offset;
+
+		REQUIRE(sum == 2 * (499 * 500 / 2));
+		REQUIRE(stats.NrOfAllocations == nrOfAllocations);
+	}
+
+	SECTION("EqualsIgnoreCase and FindBytesIgnoreCase agree with a scalar fold")
+	{
+		uint32_t seed{ 2024 };
+		const auto random = [&seed](const uint32_t max)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			return (seed >> 16) % max;
+		};
+
+		/* Letters of both cases and their neighbours, plus bytes that would turn into letters if bit 5 was set blindly */
+		constexpr unsigned char alphabet[]{ 'a', 'A', 'b', 'B', 'z', 'Z', '@', '[', '`', '{', 0xC1, 0xE1 };
+		const auto randomByte = [&]() { return alphabet[random(sizeof(alphabet))]; };
+		const auto fold = [](const unsigned char c) { return StringSearch::AsciiCaseFold::Fold(c); };
+
+		for (size_t iteration{}; iteration < 2000; ++iteration)
+		{
+			std::vector<unsigned char> a(random(100));
+			for (unsigned char& byte : a)
+				byte = randomByte();
+
+			/* Mostly equal apart from case, sometimes with a single different byte */
+			std::vector<unsigned char> b(a);
+			for (unsigned char& byte : b)
+			{
+				if (byte >= 'a' && byte <= 'z' && random(2) == 0)
+					byte = static_cast<unsigned char>(byte - ('a' - 'A'));
+			}
+			if (!b.empty() && random(2) == 0)
+				b[random(static_cast<uint32_t>(b.size()))] = randomByte();
+
+			const bool expected{ std::equal(a.begin(), a.end(), b.begin(), [&](const unsigned char x, const unsigned char y) { return fold(x) == fold(y); }) };
+
+			for (const InstructionSet set : instructionSets)
+				REQUIRE(StringSearch::EqualsIgnoreCase(a.data(), b.data(), a.size(), set) == expected);
+		}
+
+		for (size_t iteration{}; iteration < 1000; ++iteration)
+		{
+			std::vector<unsigned char> haystack(random(300));
+			for (unsigned char& byte : haystack)
+				byte = alphabet[random(4)];
+
+			std::vector<unsigned char> needle(1 + random(8));
+			for (unsigned char& byte : needle)
+				byte = alphabet[random(4)];
+
+			const unsigned char* pExpected{};
+			for (size_t i{}; i + needle.size() <= haystack.size() && !pExpected; ++i)
+			{
+				if (std::equal(needle.begin(), needle.end(), haystack.begin() + i, [&](const unsigned char x, const unsigned char y) { return fold(x) == fold(y); }))
+					pExpected = haystack.data() + i;
+			}
+
+			REQUIRE(StringSearch::FindSubstringFolded<StringSearch::AsciiCaseFold>(haystack.data(), haystack.size(), needle.data(), needle.size()) == pExpected);
+			for (const InstructionSet set : instructionSets)
+				REQUIRE(StringSearch::FindBytesIgnoreCase(haystack.data(), haystack.size(), needle.data(), needle.size(), set) == pExpected);
+		}
+
+		/* Every position is a candidate, so the fallback takes over. Matches around that point are still found */
+		std::string needle(50, 'A');
+		needle += "Ba";
+		for (size_t position{}; position < 300; ++position)
+		{
+			std::string text(position + 50, 'a');
+			text += "bA";
+			text.append(100, 'a');
+
+			for (const InstructionSet set : instructionSets)
+				REQUIRE(StringSearch::FindBytesIgnoreCase(text.data(), text.size(), needle.data(), needle.size(), set) == text.data() + position);
+		}
+	}
+
+	SECTION("Case-insensitive comparison and search")
+	{
+		const String header{ "Content-Type: Text/HTML; charset=UTF-8" };
+
+		REQUIRE(header.EqualsIgnoreCase("content-type: text/html; CHARSET=utf-8"));
+		REQUIRE(header.EqualsIgnoreCase(String{ "CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8" }));
+		REQUIRE(!header.EqualsIgnoreCase("content-type: text/html; charset=utf-16"));
+		REQUIRE(!header.EqualsIgnoreCase("content-type"));
+		REQUIRE(header.StartsWithIgnoreCase("CONTENT-type"));
+		REQUIRE(!header.StartsWithIgnoreCase("type"));
+		REQUIRE(header.EndsWithIgnoreCase("Utf-8"));
+		REQUIRE(header.EndsWithIgnoreCase(String{}));
+		REQUIRE(!header.EndsWithIgnoreCase("Content-Type: Text/HTML; charset=UTF-8!"));
+		REQUIRE(header.IndexOfIgnoreCase("text/html") == 14);
+		REQUIRE(header.IndexOfIgnoreCase(String{ "CHARSET" }) == 25);
+		REQUIRE(header.IndexOfIgnoreCase("xml") == String::NoPos);
+		REQUIRE(String{}.EqualsIgnoreCase(""));
+		REQUIRE(String{}.IndexOfIgnoreCase("a") == String::NoPos);
+
+		/* '@' and '`' differ only in bit 5 as well, but are not letters */
+		REQUIRE(!String{ "@" }.EqualsIgnoreCase("`"));
+
+		String longText{ 'x', 5000 };
+		longText[4000] = 'N';
+		longText[4001] = 'e';
+		longText[4002] = 'E';
+		REQUIRE(longText.IndexOfIgnoreCase("xNEEDLE") == String::NoPos);
+		REQUIRE(longText.IndexOfIgnoreCase("XnEe") == 3999);
+		REQUIRE(longText.Substring(0, 4000).EqualsIgnoreCase(String{ 'X', 4000 }));
+
+		/* Any fold can be plugged in, e.g. one that also treats '-' and '_' as the same character */
+		struct SeparatorFold final
+		{
+			constexpr static char Fold(const char c) { return c == '_' ? '-' : StringSearch::AsciiCaseFold::Fold(c); }
+		};
+
+		REQUIRE(header.StartsWithIgnoreCase<SeparatorFold>("content_type"));
+		REQUIRE(header.IndexOfIgnoreCase<SeparatorFold>("TYPE: text/html;_charset") == String::NoPos);
+		REQUIRE(header.IndexOfIgnoreCase<SeparatorFold>("_TYPE") == 7);
+
+		const CustomString<wchar_t> wideHeader{ L"Content-Length: 42" };
+		REQUIRE(wideHeader.EqualsIgnoreCase(L"CONTENT-LENGTH: 42"));
+		REQUIRE(wideHeader.IndexOfIgnoreCase(L"length") == 8);
+		REQUIRE(wideHeader.EndsWithIgnoreCase(L": 42"));
+	}
+
+	SECTION("IndexOf on wide strings")
+	{
+		CustomString<wchar_t> string{ L"This wide string is too long to be stored inline" };
+
+		REQUIRE(string.IndexOf(L'w') == 5);
+		REQUIRE(string.IndexOf(L'x') == CustomString<wchar_t>::NoPos);
+		REQUIRE(string.Contains(L'l'));
+	}
+}
+
+TEST_CASE("Test Pattern Matcher")
+{
+	using Matcher = PatternMatcher<char>;
+
+	SECTION("ContainsAny and FirstMatch")
+	{
+		const Matcher matcher{ std::vector<String>{ String{ "he" }, String{ "she" }, String{ "his" }, String{ "hers" } } };
+
+		REQUIRE(matcher.NrOfPatterns() == 4);
+		REQUIRE(matcher.ContainsAny(String{ "ushers" }));
+		REQUIRE(!matcher.ContainsAny(String{ "usual" }));
+		REQUIRE(!matcher.ContainsAny(String{}));
+
+		/* "she" and "he" both end at index 3, the longest one wins */
+		const Matcher::Match match{ matcher.FirstMatch(String{ "ushers" }) };
+		REQUIRE(match.Position == 1);
+		REQUIRE(match.Size == 3);
+		REQUIRE(match.PatternIndex == 1);
+
+		REQUIRE(matcher.FirstMatch(String{ "usual" }).Position == Matcher::NoPos);
+	}
+
+	SECTION("Iterating over all matches")
+	{
+		const Matcher matcher{ std::vector<String>{ String{ "he" }, String{ "she" }, String{ "his" }, String{ "hers" } } };
+		const String haystack{ "ushers" };
+
+		std::vector<Matcher::Match> matches{};
+		for (const Matcher::Match& match : matcher.Matches(haystack))
+			matches.push_back(match);
+
+		REQUIRE(matches.size() == 3);
+		REQUIRE((matches[0].Position == 1 && matches[0].PatternIndex == 1));
+		REQUIRE((matches[1].Position == 2 && matches[1].PatternIndex == 0));
+		REQUIRE((matches[2].Position == 2 && matches[2].PatternIndex == 3));
+	}
+
+	SECTION("Empty and duplicate patterns")
+	{
+		const Matcher matcher{ std::vector<String>{ String{ "" }, String{ "abc" }, String{ "abc" } } };
+
+		REQUIRE(matcher.NrOfPatterns() == 3);
+		REQUIRE(matcher.FirstMatch(String{ "xxabcxx" }).PatternIndex == 1);
+		REQUIRE(!matcher.ContainsAny(String{ "ab" }));
+
+		const Matcher empty{ std::vector<String>{} };
+		REQUIRE(!empty.ContainsAny(String{ "abc" }));
+		REQUIRE(empty.Matches(String{ "abc" }).begin() == std::default_sentinel);
+	}
+
+	SECTION("Agrees with searching every pattern on its own")
+	{
+		uint32_t seed{ 777 };
+		const auto random = [&seed](const uint32_t max)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			return (seed >> 16) % max;
+		};
+
+		const auto randomString = [&random](const size_t size)
+		{
+			String string{};
+			for (size_t i{}; i < size; ++i)
+				string += String{ static_cast<char>('a' + random(3)), 1 };
+			return string;
+		};
+
+		for (size_t iteration{}; iteration < 200; ++iteration)
+		{
+			std::vector<String> patterns{};
+			for (size_t i{}, nrOfPatterns{ 1 + random(10) }; i < nrOfPatterns; ++i)
+				patterns.push_back(randomString(1 + random(5)));
+
+			const String haystack{ randomString(random(100)) };
+			const Matcher matcher{ patterns };
+
+			size_t nrOfExpected{};
+			for (size_t end{ 1 }; end <= haystack.Size(); ++end)
+			{
+				for (size_t p{}; p < patterns.size(); ++p)
+				{
+					const size_t size{ patterns[p].Size() };
+					if (size <= end && std::memcmp(haystack.Data() + end - size, patterns[p].Data(), size) == 0)
+					{
+						/* Duplicates are only reported once, under the first index */
+						bool isDuplicate{};
+						for (size_t q{}; q < p; ++q)
+							isDuplicate |= patterns[q] == patterns[p];
+
+						nrOfExpected += !isDuplicate;
+					}
+				}
+			}
+
+			size_t nrOfMatches{};
+			size_t lastEnd{};
+			for (const Matcher::Match& match : matcher.Matches(haystack))
+			{
+				REQUIRE(match.Size == patterns[match.PatternIndex].Size());
+				REQUIRE(std::memcmp(haystack.Data() + match.Position, patterns[match.PatternIndex].Data(), match.Size) == 0);
+				REQUIRE(match.Position + match.Size >= lastEnd);
+
+				lastEnd = match.Position + match.Size;
+				++nrOfMatches;
+			}
+
+			REQUIRE(nrOfMatches == nrOfExpected);
+			REQUIRE(matcher.ContainsAny(haystack) == (nrOfExpected != 0));
+		}
+	}
+
+	SECTION("Wide characters")
+	{
+		const PatternMatcher<wchar_t> matcher{ std::vector<CustomString<wchar_t>>{ CustomString<wchar_t>{ L"needle" }, CustomString<wchar_t>{ L"pin" } } };
+
+		const PatternMatcher<wchar_t>::Match match{ matcher.FirstMatch(CustomString<wchar_t>{ L"A haystack with a needle in it" }) };
+
+		REQUIRE(match.Position == 18);
+		REQUIRE(match.PatternIndex == 0);
+		REQUIRE(!matcher.ContainsAny(CustomString<wchar_t>{ L"Nothing to see here" }));
+	}
+}
+
+TEST_CASE("Test Approximate Search")
+{
+	/* Edit distance between the needle and the best substring of the haystack that ends at every position */
+	const auto endDistances = [](const String& haystack, const String& needle)
+	{
+		std::vector<size_t> column(needle.Size() + 1);
+		for (size_t i{}; i < column.size(); ++i)
+			column[i] = i;
+
+		std::vector<size_t> distances{ column.back() };
+		for (size_t j{}; j < haystack.Size(); ++j)
+		{
+			size_t diagonal{ column[0] };
+			column[0] = 0;
+
+			for (size_t i{ 1 }; i < column.size(); ++i)
+			{
+				const size_t substitution{ diagonal + (needle[i - 1] == haystack[j] ? 0 : 1) };
+				diagonal = column[i];
+				column[i] = std::min({ substitution, column[i] + 1, column[i - 1] + 1 });
+			}
+
+			distances.push_back(column.back());
+		}
+
+		return distances;
+	};
+
+	/* Plain Levenshtein distance between needle and [pText, pText + size) */
+	const auto editDistance = [](const char* pText, const size_t size, const String& needle)
+	{
+		std::vector<size_t> row(size + 1);
+		for (size_t j{}; j < row.size(); ++j)
+			row[j] = j;
+
+		for (size_t i{ 1 }; i <= needle.Size(); ++i)
+		{
+			size_t diagonal{ row[0] };
+			row[0] = i;
+
+			for (size_t j{ 1 }; j <= size; ++j)
+			{
+				const size_t substitution{ diagonal + (needle[i - 1] == pText[j - 1] ? 0 : 1) };
+				diagonal = row[j];
+				row[j] = std::min({ substitution, row[j] + 1, row[j - 1] + 1 });
+			}
+		}
+
+		return row.back();
+	};
+
+	SECTION("Finds matches within the distance")
+	{
+		const String log{ "2024-01-01 ERROR: conection refused by host" };
+
+		ApproxMatch match{ log.IndexOfApprox("connection", 1) };
+		REQUIRE(match.Position == 18);
+		REQUIRE(match.Size == 9);
+		REQUIRE(match.Distance == 1);
+
+		REQUIRE(log.IndexOfApprox("connection", 0).Position == String::NoPos);
+		REQUIRE(log.IndexOfApprox(String{ "ERROR" }, 0).Position == 11);
+		REQUIRE(log.IndexOfApprox("refused", 2).Distance == 0);
+		REQUIRE(log.IndexOfApprox("rejected", 1).Position == String::NoPos);
+
+		/* The exact occurrence right after the approximate one is preferred */
+		match = String{ "xabcdx" }.IndexOfApprox("abcd", 1);
+		REQUIRE(match.Position == 1);
+		REQUIRE(match.Size == 4);
+		REQUIRE(match.Distance == 0);
+
+		REQUIRE(String{ "abc" }.IndexOfApprox("", 0).Size == 0);
+	}
+
+	SECTION("Needles that can be deleted entirely give the empty match")
+	{
+		/* Even when the haystack holds the needle itself */
+		for (const char* pHaystack : { "", "ab", "xxab", "ab ab" })
+		{
+			for (const size_t maxDistance : { 2u, 3u, 100u })
+			{
+				const ApproxMatch match{ String{ pHaystack }.IndexOfApprox("ab", maxDistance) };
+				REQUIRE(match.Position == 0);
+				REQUIRE(match.Size == 0);
+				REQUIRE(match.Distance == 2);
+			}
+		}
+
+		/* One edit less and the needle has to be found */
+		const ApproxMatch match{ String{ "xxab" }.IndexOfApprox("ab", 1) };
+		REQUIRE(match.Position == 2);
+		REQUIRE(match.Size == 2);
+		REQUIRE(match.Distance == 0);
+	}
+
+	SECTION("A searcher can be reused")
+	{
+		const ApproxSearcher<char> searcher{ "needle" };
+		const String first{ "a neeedle in a haystack" };
+		const String second{ "no match here" };
+
+		for (size_t i{}; i < 3; ++i)
+		{
+			const ApproxMatch match{ first.IndexOfApprox(searcher, 1) };
+			REQUIRE(match.Position + match.Size == 9);
+			REQUIRE(match.Distance == 1);
+			REQUIRE(second.IndexOfApprox(searcher, 1).Position == String::NoPos);
+		}
+	}
+
+	SECTION("Needles ending in a null character")
+	{
+		String needle{ "b" };
+		needle.Append('\0', 1);
+		const ApproxSearcher<char> searcher{ needle };
+		REQUIRE(searcher.GetNeedle().Size() == 2);
+
+		String haystack{ "abx" };
+		haystack.Append('\0', 1);
+		REQUIRE(haystack.IndexOfApprox(searcher, 0).Position == String::NoPos);
+		REQUIRE(haystack.IndexOfApprox(needle, 0).Position == String::NoPos);
+
+		const ApproxMatch match{ haystack.IndexOfApprox(searcher, 1) };
+		REQUIRE(match.Position == 1);
+		REQUIRE(match.Distance == 1);
+
+		String exact{ "ab" };
+		exact.Append('\0', 1);
+		const ApproxMatch exactMatch{ exact.IndexOfApprox(ApproxSearcher<char>{ "b\0", 2 }, 0) };
+		REQUIRE(exactMatch.Position == 1);
+		REQUIRE(exactMatch.Size == 2);
+		REQUIRE(exactMatch.Distance == 0);
+	}
+
+	SECTION("One searcher can be shared between threads")
+	{
+		/* A short needle keeps its column state on the stack, a long one on the heap */
+		for (const size_t needleSize : { 6u, 300u })
+		{
+			String needle{ 'n', needleSize };
+			needle[needleSize / 2] = 'e';
+			const ApproxSearcher<char> searcher{ needle };
+
+			String haystack{ 'x', 1000 };
+			haystack.Append('n', needleSize);
+			const ApproxMatch expected{ haystack.IndexOfApprox(searcher, 1) };
+			REQUIRE(expected.Position == 1000);
+
+			std::atomic<size_t> nrOfWrongResults{};
+			std::vector<std::thread> threads{};
+			for (size_t t{}; t < 4; ++t)
+			{
+				threads.emplace_back([&]()
+					{
+						for (size_t i{}; i < 200; ++i)
+						{
+							const ApproxMatch match{ haystack.IndexOfApprox(searcher, 1) };
+
+							if (match.Position != expected.Position || match.Size != expected.Size || match.Distance != expected.Distance)
+								++nrOfWrongResults;
+						}
+					});
+			}
+
+			for (std::thread& thread : threads)
+				thread.join();
+
+			REQUIRE(nrOfWrongResults == 0);
+		}
+	}
+
+	SECTION("Agrees with a dynamic programming search")
+	{
+		uint32_t seed{ 777 };
+		const auto random = [&seed](const uint32_t max)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			return (seed >> 16) % max;
+		};
+
+		/* Null characters are part of the alphabet, so needles can contain and end in them */
+		const char alphabet[]{ 'a', 'b', 'c', '\0' };
+
+		for (size_t iteration{}; iteration < 400; ++iteration)
+		{
+			/* Needles up to three blocks long */
+			String haystack{ 'a', random(300) };
+			for (size_t i{}; i < haystack.Size(); ++i)
+				haystack[i] = alphabet[random(4)];
+
+			String needle{ 'a', 1 + random(iteration % 4 == 0 ? 150 : 12) };
+			for (size_t i{}; i < needle.Size(); ++i)
+				needle[i] = alphabet[random(4)];
+
+			const size_t maxDistance{ random(static_cast<uint32_t>(needle.Size()) / 2 + 2) };
+			const ApproxSearcher<char> searcher{ needle };
+			const ApproxMatch match{ haystack.IndexOfApprox(searcher, maxDistance) };
+
+			const std::vector<size_t> distances{ endDistances(haystack, needle) };
+
+			size_t end{ String::NoPos };
+			for (size_t i{}; i < distances.size(); ++i)
+			{
+				if (distances[i] <= maxDistance)
+				{
+					end = i;
+					while (end + 1 < distances.size() && distances[end + 1] < distances[end])
+						++end;
+
+					break;
+				}
+			}
+
+			if (needle.Size() <= maxDistance)
+			{
+				REQUIRE(match.Position == 0);
+				REQUIRE(match.Size == 0);
+				REQUIRE(match.Distance == needle.Size());
+				continue;
+			}
+
+			if (end == String::NoPos)
+			{
+				REQUIRE(match.Position == String::NoPos);
+				continue;
+			}
+
+			REQUIRE(match.Position + match.Size == end);
+			REQUIRE(match.Distance == distances[end]);
+			REQUIRE(editDistance(haystack.Data() + match.Position, match.Size, needle) == match.Distance);
+		}
+	}
+
+	SECTION("Wide strings")
+	{
+		const CustomString<wchar_t> text{ L"Gr\u00fc\u00dfe aus K\u00f6ln" };
+		const ApproxSearcher<wchar_t> searcher{ L"Koln" };
+
+		const ApproxMatch match{ text.IndexOfApprox(searcher, 1) };
+		REQUIRE(match.Position == 10);
+		REQUIRE(match.Distance == 1);
+		REQUIRE(text.IndexOfApprox(L"Gr\u00fc\u00dfe", 0).Position == 0);
+	}
+}